@@ -3,20 +3,54 @@
 /// lecture and then manage it. The lecture consists of multiple students, each with a name, point total and optionally
 /// a grade. User can enrol new students or remove them, give different amount of points to each including substracting
 /// (with a minus sign), calculate grades for all student based on a highest score in the class and an average grade,
-/// display a formatted summary of the lecture and all students, and export the current lecture as a csv file. Both
-/// lectures and students are represented as structs and stored on the heap.
+/// display a formatted summary of the lecture and all students, and export the current lecture as a csv file. Changes
+/// of the students are appended to a journal next to the report, which is replayed when the report is loaded again.
+/// Both lectures and students are represented as structs and stored on the heap.
 //---------------------------------------------------------------------------------------------------------------------
 
+#define _POSIX_C_SOURCE 200809L//for fileno, fstat, mmap and fsync
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <ctype.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <pthread.h>
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(SCALAR_GRADING)//-DSCALAR_GRADING to measure the scalar loop
+#define GRADING_KERNELS_X86//calc grades 32 or 16 students at once with AVX2 or SSE2, chosen at runtime
+#include <immintrin.h>
+#endif
 
 typedef enum _Others_
 {
-  INITIAL_BUFFER_SIZE = 5,
-  INCREASE_RATE_OF_THE_BUFFER_SIZE = 5
+  READ_BUFFER_SIZE = 65536,
+  OUTPUT_BUFFER_SIZE = 65536,
+  PRINT_ROW_END = 52,//"\nPoints: 100\nGrade: 5\n+---------------------------+\n", what print writes after a name
+  EXPORT_ROW_END = 7,//",100,5\n", what export writes after a name
+  STUDENTS_INITIAL_CAPACITY = 16,
+  MAX_LOAD_THREADS = 64,
+  BATCH_BUFFER_SIZE = 1048576,
+  NAME_INDEX_INITIAL_CAPACITY = 16,
+  MAX_POINTS = 100,
+  GRADE_THRESHOLDS = 4,
+  ARENA_INITIAL_BLOCK_SIZE = 4096,
+  SHORT_NAME_SIZE = 23,//names up to 22 characters are stored in the student itself
+  LONG_NAME = 255,
+  EMPTY_SLOT = -1,
+  NO_STUDENT = -1,//returned by studentNameInLecture, any error value could also be a valid index
+  SNAPSHOT_MAGIC = 0x534C3441,//"A4LS" in little endian, a snapshot from a machine with other byte order is not loaded
+  SNAPSHOT_VERSION = 1,
+  CHECKSUM_MODULUS = 65521,//Adler-32
+  CHECKSUM_BLOCK = 5552,//bytes that can be summed before the sums have to be reduced, so that they do not overflow
+  JOURNAL_SYNC_GROUP = 64,//records written to the journal between two fsyncs
+  JOURNAL_COMPACTION_RECORDS = 65536,//a journal with more changes than this and than students is compacted
+  COMMAND_TABLE_SIZE = 32,//power of two, see commandSlot
+  ANY_ARGUMENTS = -1
 } Others;
 
 typedef enum _Returns_ 
@@ -29,7 +63,6 @@ typedef enum _Returns_
 typedef enum _Errors_
 {
   MEMORY_ERROR = 300,
-  UNKNOWN_COMMAND,
   WRONG_ARGUMENT,
   INCORRECT_LECTURE_NAME,
   FILE_ERROR,
@@ -38,37 +71,192 @@ typedef enum _Errors_
   UNSUCCESSFUL_LOAD,
   NOT_UNIQUE_NAME,
   STUDENT_NOT_FOUND,
-  POINTS_LIMIT
+  POINTS_LIMIT,
+  WRITE_ERROR
 } Errors;
 
-typedef enum _Commands_ 
-{ 
-  CREATE = 90,
-  LOAD,
-  ENROL,
-  REMOVE,
-  GIVE,
-  CALC,
-  PRINT,
-  EXPORT,
-  CLOSE
-} Commands;
+typedef enum _Modes_
+{
+  GLOBAL_MODE = 1,
+  LECTURE_MODE = 2
+} Modes;
 
 typedef struct _Student_
 {
-  char* name_;
-  int points_;
-  int grade_;
-} Student;
+  char name_[SHORT_NAME_SIZE];//short name with '\0', or the address of a long name stored elsewhere
+  uint8_t length_;//length of the short name, LONG_NAME for a long name
+} Student;//24 bytes, points and grades are not stored here but in the columns points_ and grades_ of the lecture
+
+typedef struct _NameBlock_
+{
+  char* names_;//names of many students (or other strings of the lecture), one after another, each ending with '\0'
+  long size_;
+  long used_;//bytes given out by allocateFromArena, blocks of bulk operations are used as a whole
+  struct _NameBlock_* next_;
+} NameBlock;
+
+typedef enum _GradesState_
+{
+  NO_GRADES,//neither calculated nor loaded
+  LOADED_GRADES,//loaded from the file, there is no average grade
+  CALCULATED_GRADES,//calculated with calc, average grade is valid as well
+  OUTDATED_GRADES//points or students have changed since the grades were loaded or calculated
+} GradesState;
+
+typedef enum _JournalBase_
+{
+  NO_BASE,//the lecture is not its report, its changes are not journaled until export
+  REPORT_BASE//the lecture is its report, the journal starts from it
+} JournalBase;
+
+typedef struct _SortedOrder_
+{
+  int* indices_;//indices of the students in sorted order, NULL if the order has to be sorted again
+  int length_;//amount of students at the beginning of the order that are sorted, the rest was not selected
+} SortedOrder;
+
+typedef struct _Journal_
+{
+  FILE* file_;//reports/<name>.log, NULL until the lecture changes for the first time or if the journal has failed
+  JournalBase base_;//what the records are replayed on, the first line of the journal says the same
+  long records_;//changes of students written since the journal was started
+  int unsynced_records_;//records (commands) written since the last fsync
+  bool failed_;//the journal could not be written, changes stay only in memory until the next export
+} Journal;
 
 typedef struct _Lecture_
 {
   char* name_;
   Student* students_;
+  uint8_t* points_;//points of the students, one column for all students, so that calc goes through contiguous memory
+  uint8_t* grades_;//grades of the students, as the column above
   int amount_students_;
-  float average_grade_;
+  int capacity_;//amount of students the arrays (students_, points_, grades_) can hold without reallocation
+  float average_grade_;//valid only if grades_state_ is CALCULATED_GRADES
+  GradesState grades_state_;//grades_ of the students are valid only if it is LOADED_GRADES or CALCULATED_GRADES
+  bool lazy_grades_;//calculated with calc --lazy, grades are taken from grade_of_points_ instead of grades_
+  int graded_students_;//amount of students at the time of calc, students enrolled later have no grade yet
+  int points_histogram_[MAX_POINTS + 1];//amount of students with each number of points
+  char grade_of_points_[MAX_POINTS + 1];//grade for each number of points, filled by calc
+  int* name_index_;//open addressing hash table, every slot holds an index of a student or EMPTY_SLOT
+  int name_index_capacity_;//always a power of two, so that we can use a mask instead of %
+  NameBlock* name_blocks_;//arena of the lecture, holds long names, the name of the lecture and its report path
+  long arena_block_size_;//size of the next block of the arena
+  char* report_path_;
+  char* report_temp_path_;//export writes here first and renames the file, so the report is never half written
+  char* snapshot_path_;//export --binary writes a snapshot here, through snapshot_temp_path_
+  char* snapshot_temp_path_;
+  uint64_t* changed_points_;//bit for every student whose points changed since the snapshot was written, NULL if
+                            //the snapshot cannot be patched by export --incremental, see patchSnapshot
+  uint32_t snapshot_checksum_;//checksum of the snapshot that can be patched
+  char* journal_path_;//every change of the students is appended here, see commitJournal
+  char* journal_temp_path_;
+  Journal journal_;
+  SortedOrder points_order_;//cached order of print --sort points, from the highest points down
+  SortedOrder names_order_;//cached order of print --sort name
 } Lecture;
 
+typedef void (*GradingKernel)(uint8_t* points, uint8_t* grades, int amount_students, int thresholds[]);
+
+typedef struct _LoadChunk_
+{
+  char* rows_;//part of the mapped file, ends right after a '\n' (except the last chunk)
+  long length_;
+  char* names_;//part of the name block where names of this chunk are copied
+  Student* students_;
+  uint8_t* points_;
+  uint8_t* grades_;
+  int amount_students_;
+  bool long_names_;//some names of the chunk are long, so they stay in the name block
+  int error_;//0 or error of the first invalid row of the chunk
+} LoadChunk;
+
+typedef struct _LineReader_
+{
+  char* buffer_;//reused for every line, grown by getline
+  size_t size_;
+  FILE* input_;
+} LineReader;
+
+typedef struct _Token_
+{
+  char* start_;//points into the line, NULL if there is no token
+  int length_;
+} Token;
+
+typedef struct _Arguments_
+{
+  char* next_;//next argument, every argument is terminated by '\0' in the line
+  int amount_;//amount of arguments that are left
+} Arguments;
+
+typedef struct _OutputBuffer_
+{
+  FILE* file_;
+  char* data_;//usually an array on the stack of the writer
+  int size_;
+  int used_;
+  bool failed_;//a write has failed, everything after it is dropped
+  uint32_t* checksum_;//if it is not NULL, the checksum of everything written is updated here
+} OutputBuffer;
+
+typedef struct _SnapshotHeader_
+{
+  uint32_t magic_;
+  uint32_t version_;
+  uint32_t amount_students_;
+  uint32_t checksum_;//Adler-32 of everything after the header
+  uint64_t names_size_;//size of the name blob, every name ends with '\0'
+} SnapshotHeader;//followed by the points column, the grades column, uint32_t offsets of the names and the name blob
+
+typedef struct _RegisteredLecture_
+{
+  char* name_;//own copy, the lecture may be evicted
+  Lecture* lecture_;//NULL if the lecture is evicted to its spill file
+  char* spill_path_;//reports/.<name>.bin, a snapshot of the evicted lecture
+  char* spill_temp_path_;
+  GradesState grades_state_;//a snapshot has only the grades, these two are kept to restore the evicted lecture
+  float average_grade_;
+  long memory_;//bytes of the lecture when it stopped being the current one, see lectureMemory
+  Journal journal_;//journal of the evicted lecture, it stays open and is given back when the lecture is loaded
+  struct _RegisteredLecture_* newer_;//list of the lectures in memory, from the most recently used one
+  struct _RegisteredLecture_* older_;
+} RegisteredLecture;
+
+typedef struct _Registry_
+{
+  RegisteredLecture** table_;//open addressing hash table by name, NULL for an empty slot
+  int capacity_;//always a power of two
+  int amount_lectures_;
+  RegisteredLecture* current_;//lecture of the lecture mode, NULL in the global mode
+  RegisteredLecture* newest_;
+  RegisteredLecture* oldest_;
+  long resident_memory_;//bytes of the lectures in memory except the current one
+  long budget_;//lectures are evicted from the oldest one when all of them need more bytes, 0 for no limit
+} Registry;
+
+typedef struct _Session_
+{
+  LineReader reader_;
+  bool batch_;//commands come from a file or a pipe (--batch), prompts and lists of commands are not printed
+  int commands_;
+  int failed_commands_;
+  Registry registry_;//all open lectures
+} Session;
+
+typedef int (*CommandHandler)(Session* session, Arguments arguments, bool* global_mode);
+typedef bool (*ArgumentsCheck)(Arguments arguments);
+
+typedef struct _CommandEntry_
+{
+  char* name_;
+  int modes_;//GLOBAL_MODE and/or LECTURE_MODE
+  int min_arguments_;
+  int max_arguments_;//ANY_ARGUMENTS if there is no limit
+  ArgumentsCheck check_;//NULL if the command has no options
+  CommandHandler handler_;//NULL for exit
+} CommandEntry;
+
 //---------------------------------------------------------------------------------------------------------------------
 /// @brief This function prints a welcome message.
 void welcomeMessage(void)
@@ -85,192 +273,274 @@ void globalCommandsPrint(void)
   printf("\nPlease enter one of the following commands:\n");
   printf("  create - create new lecture\n");
   printf("  load   - load existing lecture\n");
+  printf("  use    - continue with an open lecture\n");
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function finds end of the string and returns a pointer to it.
-/// @param buffer initial string
-/// @return pointer type char to the '\0' or NULL if it was not found
-char* findEndOfTheString(char* buffer)
+/// @brief This function handles an arbitrary long user input. The line is read with getline from the input of the
+/// reader into its buffer, which is reused for every line of the session and grows geometrically only when a line does
+/// not fit, so a long line costs a few reallocations instead of one per few characters. The '\n' is replaced with
+/// '\0'.
+/// @param reader line reader of the session
+/// @return pointer to the line inside the buffer of the reader, it stays valid until the next call, NULL if an error
+/// occured or the input has ended
+char* readUserInput(LineReader* reader)
 {
-  for(char* iterator = buffer; *iterator != '\0'; ++iterator)
+  ssize_t length = getline(&reader->buffer_, &reader->size_, reader->input_);
+  if(length == -1)
   {
-    if(*iterator == '\n')
-    {
-      return iterator;
-    }
+    return NULL;
   }
-  return NULL;
+  if(length > 0 && reader->buffer_[length - 1] == '\n')
+  {//if user somehow entered a string without '\n' there is nothing to replace
+    reader->buffer_[length - 1] = '\0';
+  }
+  return reader->buffer_;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function increases size of the buffer by a certain rate.
-/// @param buffer initial string
-/// @param buffer_size initial size of the buffer
-/// @return buffer - pointer to the increased buffer, NULL if an error occured
-char* increaseBufferSize(char* buffer, int* buffer_size)
+/// @brief This function finds the next token of a line, tokens are separated by spaces and tabs. The line is not
+/// written to and all state is in the position, so lines can be tokenised by several threads at once.
+/// @param position position in the line, it is moved behind the token
+/// @return the token, its start is NULL if the line has no more tokens
+Token nextToken(char** position)
 {
-  int new_buffer_size = *buffer_size + INCREASE_RATE_OF_THE_BUFFER_SIZE;
-  char* temporal_buffer = realloc(buffer, new_buffer_size * sizeof(char));
-  if(temporal_buffer == NULL)
-  {
-    return NULL;
-  }
-  buffer = temporal_buffer;//realloc automatically frees so we do not have to worry about that
-  *buffer_size = new_buffer_size;
-  return buffer;
+  char* start = *position + strspn(*position, " \t\v");
+  int length = strcspn(start, " \t\v");
+  *position = start + length;
+  return (Token){length == 0 ? NULL : start, length};
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function handles an arbitrary long user input. It starts with a fixed-size buffer then increases it
-/// until all input has been read and stored on the heap using dynamic memory allocation.
-/// Remark: readUserInput, increaseBufferSize and findEndOfTheString were taken from a3, as it has the same requirement
-/// of the arbitrary input.
-/// @return pointer to the allocated memory on the heap, NULL if an error occured
-char* readUserInput(void)
+/// @brief This function splits the rest of a line into arguments. Every argument is terminated by '\0' in place, so
+/// the arguments can be used as strings without copying them, and there can be any amount of them.
+/// @param line rest of the line
+/// @return arguments of the line
+Arguments splitArguments(char* line)
 {
-  int buffer_size = INITIAL_BUFFER_SIZE;
-  char* initial_buffer = malloc(buffer_size * sizeof(char));
-  if(initial_buffer == NULL)
+  Arguments arguments = {line, 0};
+  for(Token token = nextToken(&line); token.start_ != NULL; token = nextToken(&line))
   {
-    return NULL;
-  }
-  if(fgets(initial_buffer, buffer_size, stdin) == NULL)//If user presses EOF
-  {
-    free(initial_buffer);
-    return NULL;
-  }
-  int offset = 1;                       //- 1 because of \0 
-  while(findEndOfTheString(initial_buffer + offset - 1) == NULL)
-  {                                     //+ offset - 1 to avoid checking parts that were already checked
-    char* updated_buffer = increaseBufferSize(initial_buffer, &buffer_size);
-    if(updated_buffer == NULL)
-    {
-      free(initial_buffer);
-      return NULL;
-    }
-    initial_buffer = updated_buffer;
-    offset = buffer_size - INCREASE_RATE_OF_THE_BUFFER_SIZE;
-    if(fgets(initial_buffer + offset - 1, INCREASE_RATE_OF_THE_BUFFER_SIZE + 1, stdin) == NULL)
+    if(*line != '\0')
     {
-      break;//if user somehow entered a string without '\n'
+      line++;//behind the separator, which is overwritten now
     }
+    token.start_[token.length_] = '\0';
+    arguments.amount_++;
   }
-  char* newline = findEndOfTheString(initial_buffer);
-  if(newline != NULL)
-  {//we do this to change '\n' to '\0' and if there was EOF case there is no '\n'
-    *newline = '\0';
-  }
-  return initial_buffer;
+  return arguments;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function identifies the command that the user has typed in and returns a value assigned to it. 
-/// @param token_1 string to be identified
-/// @return value of a certain command, or UNKNOWN_COMMAND if the command typed is unknown
-int identifyCommand(char* token_1)
+/// @brief This function takes the next argument from the arguments split by splitArguments.
+/// @param arguments arguments, the argument is removed from them
+/// @return the argument, NULL if there are no arguments left
+char* nextArgument(Arguments* arguments)
 {
-  if(token_1 == NULL)//to avoid segmentation crash with strcmp
+  if(arguments->amount_ == 0)
   {
-    return UNKNOWN_COMMAND;
+    return NULL;
   }
-  if(strcmp(token_1, "exit") == 0)
-  {
-    return QUIT;
+  char* argument = arguments->next_;
+  while(*argument == '\0' || *argument == ' ' || *argument == '\t' || *argument == '\v')
+  {//an earlier argument was terminated here, arguments are never empty
+    argument++;
   }
-  if(strcmp(token_1, "create") == 0)
+  arguments->next_ = argument + strlen(argument);
+  arguments->amount_--;
+  return argument;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function returns an argument by its position without removing any argument.
+/// @param arguments arguments
+/// @param index position of the argument, counted from 0
+/// @return the argument, NULL if there are not so many arguments
+char* argumentAt(Arguments arguments, int index)
+{
+  char* argument = nextArgument(&arguments);
+  for(int argument_index = 0; argument_index < index; argument_index++)
   {
-    return CREATE;
+    argument = nextArgument(&arguments);
   }
-  if(strcmp(token_1, "load") == 0)
+  return argument;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks the amount of threads for load --threads. It must be a number from 1 to
+/// MAX_LOAD_THREADS.
+/// @param amount_threads string to be checked
+/// @return amount of threads on success, WRONG_ARGUMENT if the string is not a valid amount
+int checkAmountThreads(char* amount_threads)
+{
+  int length = strlen(amount_threads);
+  if(length > 2)
   {
-    return LOAD;
+    return WRONG_ARGUMENT;
   }
-  if(strcmp(token_1, "enrol") == 0)
+  for(int character_index = 0; character_index < length; character_index++)
   {
-    return ENROL;
+    if(isdigit(*(amount_threads + character_index)) == 0)
+    {
+      return WRONG_ARGUMENT;
+    }
   }
-  if(strcmp(token_1, "remove") == 0)
+  int number = atoi(amount_threads);
+  if(number < 1 || number > MAX_LOAD_THREADS)
   {
-    return REMOVE;
+    return WRONG_ARGUMENT;
   }
-  if(strcmp(token_1, "give") == 0)
+  return number;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function converts an argument of print to a number, the argument may only consist of digits.
+/// @param argument argument of print, NULL if there is none
+/// @param number the number is written here
+/// @return 0 on success, WRONG_ARGUMENT if the argument is missing or not a number
+int parseNumber(char* argument, int* number)
+{
+  if(argument == NULL || *argument == '\0' || strlen(argument) > 9)//more digits would not fit into an int
   {
-    return GIVE;
+    return WRONG_ARGUMENT;
   }
-  if(strcmp(token_1, "calc") == 0)
+  for(int character_index = 0; argument[character_index] != '\0'; character_index++)
   {
-    return CALC;
+    if(isdigit(argument[character_index]) == 0)
+    {
+      return WRONG_ARGUMENT;
+    }
   }
-  if(strcmp(token_1, "print") == 0)
+  *number = atoi(argument);
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function converts the argument of print --limit to a number of students.
+/// @param argument argument after --limit, NULL if there is none
+/// @param limit the number is written here
+/// @return 0 on success, WRONG_ARGUMENT if the argument is missing or not a positive number
+int parseLimit(char* argument, int* limit)
+{
+  if(parseNumber(argument, limit) == WRONG_ARGUMENT || *limit < 1)
   {
-    return PRINT;
+    return WRONG_ARGUMENT;
   }
-  if(strcmp(token_1, "export") == 0)
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function converts the argument of print --range, which looks like <start>:<count>. Start is the position
+/// of the first printed student, counted from 0, count has to be positive.
+/// @param argument argument after --range, NULL if there is none
+/// @param start position of the first student is written here
+/// @param count amount of students is written here
+/// @return 0 on success, WRONG_ARGUMENT if the argument is missing or invalid
+int parseRange(char* argument, int* start, int* count)
+{
+  char* colon = argument == NULL ? NULL : strchr(argument, ':');
+  if(colon == NULL)
   {
-    return EXPORT;
+    return WRONG_ARGUMENT;
   }
-  if(strcmp(token_1, "close") == 0)
+  *colon = '\0';
+  if(parseNumber(argument, start) == WRONG_ARGUMENT || parseLimit(colon + 1, count) == WRONG_ARGUMENT)
   {
-    return CLOSE;
+    return WRONG_ARGUMENT;
   }
-  return UNKNOWN_COMMAND;
+  return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function tokenises input of the user, identifies the command, then checks the amount of the arguments
-/// for each command.
-/// @param input input of the user
-/// @param token_1 first token
-/// @param token_2 second token
-/// @param token_3 third token
-/// @return value of a command, QUIT if the user typed "exit", WRONG_ARGUMENT if command is unknown or wrong number of
-/// arguments was used
-int checkArgumentsGlobal(char** input, char** token_1, char** token_2, char** token_3)
-{
-  *token_1 = strtok(*input, " \t\v");
-  *token_2 = strtok(NULL, " \t\v");
-  *token_3 = strtok(NULL, " \t\v");
-  int command = identifyCommand(*token_1);
-  if(command == UNKNOWN_COMMAND)
-  {
-    printf("Error: Unknown command!\n");
-    return WRONG_ARGUMENT;
-  }
-  if(command == QUIT && *token_2 == NULL)
+/// @brief This function checks the options of load, which can also be used as load --mmap <path> or
+/// load --threads <amount> <path>.
+/// @param arguments arguments, there is at least one
+/// @return true if the options are valid, false otherwise
+bool checkLoadOptions(Arguments arguments)
+{
+  char* option = argumentAt(arguments, 0);
+  if(strcmp(option, "--mmap") == 0)//load --mmap <path>
   {
-    return QUIT;
+    return arguments.amount_ == 2;
   }
-  if(command == QUIT && *token_2 != NULL)
+  if(strcmp(option, "--threads") == 0)//load --threads <amount> <path>
   {
-    printf("Error: Invalid command usage!\n");
-    return WRONG_ARGUMENT;
+    return arguments.amount_ == 3 && checkAmountThreads(argumentAt(arguments, 1)) != WRONG_ARGUMENT;
   }
-  if(command != CREATE && command != LOAD)
+  return arguments.amount_ == 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks the options of enrol <name> and enrol --from <roster>.
+/// @param arguments arguments, there is at least one
+/// @return true if the options are valid, false otherwise
+bool checkEnrolOptions(Arguments arguments)
+{
+  return arguments.amount_ == (strcmp(argumentAt(arguments, 0), "--from") == 0 ? 2 : 1);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks the options of remove <names> and remove --swap <names>.
+/// @param arguments arguments, there is at least one
+/// @return true if the options are valid, false otherwise
+bool checkRemoveOptions(Arguments arguments)
+{
+  return strcmp(argumentAt(arguments, 0), "--swap") != 0 || arguments.amount_ > 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks the options of calc and calc --lazy.
+/// @param arguments arguments
+/// @return true if the options are valid, false otherwise
+bool checkCalcOptions(Arguments arguments)
+{
+  return arguments.amount_ == 0 || strcmp(argumentAt(arguments, 0), "--lazy") == 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks the options of print, print --sort points|name [--limit|--range <argument>],
+/// print --limit <count> and print --range <start>:<count>. The argument of an option is checked when it is printed.
+/// @param arguments arguments
+/// @return true if the options are valid, false otherwise
+bool checkPrintOptions(Arguments arguments)
+{
+  char* option = argumentAt(arguments, 0);
+  if(option == NULL)
   {
-    printf("Error: This command cannot be used in the current mode!\n");
-    return WRONG_ARGUMENT;
+    return true;
   }
-  if(*token_2 == NULL)
+  if(strcmp(option, "--sort") == 0)
   {
-    printf("Error: Invalid command usage!\n");
-    return WRONG_ARGUMENT;
+    char* order = argumentAt(arguments, 1);
+    char* sort_option = argumentAt(arguments, 2);
+    return order != NULL && (strcmp(order, "points") == 0 || strcmp(order, "name") == 0) &&
+           (sort_option == NULL || strcmp(sort_option, "--limit") == 0 || strcmp(sort_option, "--range") == 0);
   }
-  if(*token_3 != NULL)
+  if(strcmp(option, "--limit") == 0 || strcmp(option, "--range") == 0)
   {
-    printf("Error: Invalid command usage!\n");
-    return WRONG_ARGUMENT;
+    return arguments.amount_ == 2;
   }
-  return command;
+  return false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks the options of export, export --binary and export --incremental.
+/// @param arguments arguments
+/// @return true if the options are valid, false otherwise
+bool checkExportOptions(Arguments arguments)
+{
+  char* option = argumentAt(arguments, 0);
+  return option == NULL || strcmp(option, "--binary") == 0 || strcmp(option, "--incremental") == 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 /// @brief This function checks the name of the lecture. Name is allowed to have letters and digits in it.
 /// @param name string to be checked
+/// @param name_length length of the name, the name does not have to be terminated
 /// @return 0 if name is valid, INCORRECT_LECTURE_NAME if name is invalid
-int checkLectureName(char* name)
+int checkLectureName(char* name, int name_length)
 {
-  for(int character_index = 0; *(name + character_index) != '\0'; character_index++)
+  for(int character_index = 0; character_index < name_length; character_index++)
   {
     if(isalnum(*(name + character_index)) == 0)
     {
@@ -282,14 +552,83 @@ int checkLectureName(char* name)
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function creates a lecture on the heap. It checks the name of the lecture, assigns it to the lecture
-/// and initialises other lecture properties.
+/// @brief This function allocates a name block and puts it at the beginning of the list of name blocks of the lecture.
+/// The whole block counts as used, it is filled by the caller.
+/// @param lecture lecture
+/// @param size size of the block in bytes
+/// @return the new block, NULL if allocation failed
+NameBlock* addNameBlock(Lecture* lecture, long size)
+{
+  NameBlock* block = malloc(sizeof(NameBlock));
+  if(block == NULL)
+  {
+    return NULL;
+  }
+  block->names_ = malloc(size);
+  if(block->names_ == NULL)
+  {
+    free(block);
+    return NULL;
+  }
+  block->size_ = size;
+  block->used_ = size;
+  block->next_ = lecture->name_blocks_;
+  lecture->name_blocks_ = block;
+  return block;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function frees the first name block of the lecture. It is used to undo addNameBlock when the names
+/// could not be used.
+/// @param lecture lecture
+void removeFirstNameBlock(Lecture* lecture)
+{
+  NameBlock* block = lecture->name_blocks_;
+  lecture->name_blocks_ = block->next_;
+  free(block->names_);
+  free(block);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function allocates memory from the arena of the lecture, which consists of its name blocks. It only
+/// moves the position in the first block forward, a new block is added when the first one is full, and every new
+/// block is twice as big as the previous one. Nothing is freed separately, the arena is released with the lecture.
+/// @param lecture lecture
+/// @param size amount of bytes
+/// @return allocated memory, NULL if allocation failed
+char* allocateFromArena(Lecture* lecture, long size)
+{
+  NameBlock* block = lecture->name_blocks_;
+  if(block == NULL || block->size_ - block->used_ < size)
+  {
+    long block_size = lecture->arena_block_size_;
+    while(block_size < size)
+    {
+      block_size *= 2;
+    }
+    block = addNameBlock(lecture, block_size);
+    if(block == NULL)
+    {
+      return NULL;
+    }
+    block->used_ = 0;
+    lecture->arena_block_size_ = block_size * 2;
+  }
+  char* memory = block->names_ + block->used_;
+  block->used_ += size;
+  return memory;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function creates a lecture on the heap. It checks the name of the lecture, initialises lecture
+/// properties and stores the name of the lecture and the path of its report in the arena of the lecture.
 /// @param name name of the lecture
+/// @param name_length length of the name, the name does not have to be terminated
 /// @param lecture pointer to the address of lecture on the heap(array of lectures)
 /// @return 0 if success, INCORRECT_LECTURE_NAME if the name is invalid, MEMORY_ERROR if allocation failed
-int createLecture(char* name, Lecture** lecture)
+int createLecture(char* name, int name_length, Lecture** lecture)
 {
-  if(checkLectureName(name) == INCORRECT_LECTURE_NAME)
+  if(checkLectureName(name, name_length) == INCORRECT_LECTURE_NAME)
   {
     return INCORRECT_LECTURE_NAME;
   }
@@ -298,1102 +637,3899 @@ int createLecture(char* name, Lecture** lecture)
   {
     return MEMORY_ERROR;
   }
-  (*lecture)->name_ = malloc(strlen(name) + 1);
-  if((*lecture)->name_ == NULL)
+  (*lecture)->name_blocks_ = NULL;
+  (*lecture)->arena_block_size_ = ARENA_INITIAL_BLOCK_SIZE;
+  (*lecture)->name_ = allocateFromArena(*lecture, name_length + 1);
+  (*lecture)->report_path_ = allocateFromArena(*lecture, name_length + 13);//reports/.csv - 12 characters + \0
+  (*lecture)->report_temp_path_ = allocateFromArena(*lecture, name_length + 17);//reports/.csv.tmp - 16 characters
+  (*lecture)->snapshot_path_ = allocateFromArena(*lecture, name_length + 13);
+  (*lecture)->snapshot_temp_path_ = allocateFromArena(*lecture, name_length + 17);
+  (*lecture)->journal_path_ = allocateFromArena(*lecture, name_length + 13);
+  (*lecture)->journal_temp_path_ = allocateFromArena(*lecture, name_length + 17);
+  if((*lecture)->name_ == NULL || (*lecture)->report_path_ == NULL || (*lecture)->report_temp_path_ == NULL ||
+     (*lecture)->snapshot_path_ == NULL || (*lecture)->snapshot_temp_path_ == NULL ||
+     (*lecture)->journal_path_ == NULL || (*lecture)->journal_temp_path_ == NULL)
   {
+    while((*lecture)->name_blocks_ != NULL)
+    {
+      removeFirstNameBlock(*lecture);
+    }
     free(*lecture);
     return MEMORY_ERROR;
   }
-  strcpy((*lecture)->name_, name);
+  memcpy((*lecture)->name_, name, name_length);
+  (*lecture)->name_[name_length] = '\0';
+  sprintf((*lecture)->report_path_, "reports/%s.csv", (*lecture)->name_);//printf, but in string
+  sprintf((*lecture)->report_temp_path_, "reports/%s.csv.tmp", (*lecture)->name_);
+  sprintf((*lecture)->snapshot_path_, "reports/%s.bin", (*lecture)->name_);
+  sprintf((*lecture)->snapshot_temp_path_, "reports/%s.bin.tmp", (*lecture)->name_);
+  sprintf((*lecture)->journal_path_, "reports/%s.log", (*lecture)->name_);
+  sprintf((*lecture)->journal_temp_path_, "reports/%s.log.tmp", (*lecture)->name_);
   (*lecture)->students_ = NULL;
+  (*lecture)->points_ = NULL;
+  (*lecture)->grades_ = NULL;
   (*lecture)->amount_students_ = 0;
+  (*lecture)->capacity_ = 0;
   (*lecture)->average_grade_ = 0;
+  (*lecture)->grades_state_ = NO_GRADES;
+  (*lecture)->lazy_grades_ = false;
+  (*lecture)->graded_students_ = 0;
+  memset((*lecture)->points_histogram_, 0, sizeof((*lecture)->points_histogram_));
+  (*lecture)->name_index_ = NULL;
+  (*lecture)->name_index_capacity_ = 0;
+  (*lecture)->points_order_.indices_ = NULL;
+  (*lecture)->points_order_.length_ = 0;
+  (*lecture)->names_order_.indices_ = NULL;
+  (*lecture)->names_order_.length_ = 0;
+  (*lecture)->changed_points_ = NULL;
+  (*lecture)->snapshot_checksum_ = 0;
+  (*lecture)->journal_.file_ = NULL;
+  (*lecture)->journal_.base_ = NO_BASE;
+  (*lecture)->journal_.records_ = 0;
+  (*lecture)->journal_.unsynced_records_ = 0;
+  (*lecture)->journal_.failed_ = false;
   return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function finds the last slash in the path, then puts the null terminator to remove ".csv".
+/// @brief This function finds the last slash in the path, the name of the lecture is between it and ".csv". The path
+/// is not changed, so it can still be used in error messages.
 /// @param path string, from which we need to derive the name of the function
-/// @return name of the lecture
-char* getNameForLecture(char* path)
+/// @param name_length length of the name is written here
+/// @return name of the lecture, it is not terminated
+char* getNameForLecture(char* path, int* name_length)
 {
-  bool slash = false;
   int path_length = strlen(path);
-  int last_slash = 0;
+  int start = 0;
   for(int character_index = path_length - 1; character_index >= 0 ; character_index--)
   {
     if(*(path + character_index) == '/')
     {
-      last_slash = character_index;
-      slash = true;
+      start = character_index + 1;
       break;
     }
   }
-  int name_length = path_length - last_slash - 5;//.csv\0 - 5 characters
-  if(slash)
+  *name_length = path_length - 4 - start;//.csv - 4 characters
+  if(*name_length < 0)//too short for an extension, the whole file name is the name
   {
-    *(path + last_slash + name_length + 1) = '\0';
-    return path + last_slash + 1;
+    *name_length = path_length - start;
   }
-  *(path + name_length + 1) = '\0';
-  return path;
+  return path + start;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function calculates amount of students in the file.
-/// @param file file
-/// @return amount of students
-int calculateAmountOfStudents(FILE* file)
+/// @brief This function changes the size of the array of students and of the columns with their points and grades.
+/// If a reallocation fails, the arrays reallocated before it cannot be given back, so the arrays can have different
+/// sizes then. The capacity is always what every one of them can hold: the old one if they grow, the new one as soon
+/// as the first of them has shrunk.
+/// @param students array of students
+/// @param points column with points
+/// @param grades column with grades
+/// @param capacity amount of students all arrays can hold, it is updated also if a reallocation fails
+/// @param new_capacity amount of students the arrays have to be able to hold
+/// @return 0 if success, MEMORY_ERROR if allocation failed
+int reserveColumns(Student** students, uint8_t** points, uint8_t** grades, int* capacity, int new_capacity)
 {
-  int amount_students = 0;
-  int current_character = 0;
-  while(current_character != EOF)
+  int smallest_capacity = *capacity < new_capacity ? *capacity : new_capacity;
+  Student* new_students = realloc(*students, new_capacity * sizeof(Student));
+  if(new_students == NULL)
   {
-    current_character = fgetc(file);
-    if(current_character == '\n')
-    {
-      amount_students++;
-    }
+    return MEMORY_ERROR;
   }
-  rewind(file);
-  return amount_students;
+  *students = new_students;
+  *capacity = smallest_capacity;//the columns may still have the old size
+  uint8_t* new_points = realloc(*points, new_capacity * sizeof(uint8_t));
+  if(new_points == NULL)
+  {
+    return MEMORY_ERROR;
+  }
+  *points = new_points;
+  uint8_t* new_grades = realloc(*grades, new_capacity * sizeof(uint8_t));
+  if(new_grades == NULL)
+  {
+    return MEMORY_ERROR;
+  }
+  *grades = new_grades;
+  *capacity = new_capacity;
+  return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function allocates an array of students on the heap in the lecture.
+/// @brief This function changes the size of the array of students in the lecture together with the columns of points
+/// and grades. If the reallocation fails, the capacity is what the arrays can still hold (see reserveColumns).
 /// @param lecture lecture
-/// @param amount_students amount of students
+/// @param capacity amount of students the arrays have to be able to hold
 /// @return 0 if success, MEMORY_ERROR if allocation failed
-int allocateStudents(Lecture* lecture, int amount_students)
+int reserveStudents(Lecture* lecture, int capacity)
 {
-  lecture->students_ = calloc(amount_students, sizeof(Student));
-  if(lecture->students_ == NULL)
-  {
-    return MEMORY_ERROR;
-  }
-  return 0;
+  return reserveColumns(&lecture->students_, &lecture->points_, &lecture->grades_, &lecture->capacity_, capacity);
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function checks the name of the student. Name must be alphabetic.
-/// @param students_name string to be checked
-/// @return 0 if name is valid, INCORRECT_STUDENTS_NAME is name is invalid
-int checkStudentsName(char* students_name)
+/// @brief This function doubles the array of students if there is no space for one more student, so that adding
+/// students one by one costs amortized O(1).
+/// @param lecture lecture
+/// @return 0 if success, MEMORY_ERROR if allocation failed
+int growStudentsIfFull(Lecture* lecture)
 {
-  char current_character = 0;
-  for(int character_index = 0; *(students_name + character_index) != '\0'; character_index++)
+  if(lecture->amount_students_ < lecture->capacity_)
   {
-    current_character = *(students_name + character_index);
-    if(isalpha(current_character) == 0)
-    {
-      printf("Error: Name contains invalid characters!\n");
-      return INCORRECT_STUDENTS_NAME;
-    }
+    return 0;
   }
-  return 0;
+  return reserveStudents(lecture, lecture->capacity_ == 0 ? STUDENTS_INITIAL_CAPACITY : lecture->capacity_ * 2);
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function takes an array of characters that contains points and other symbols. It distinguishes
-/// characters that are relevant for the points and converts them to the number. It also checks whether the points are
-/// in a range from 0 to 100. If there are any inappropriate characters it prints error message for a malformed row.
-/// @param points_array array where point characters are awaited to be
-/// @param path file path string, is used to print the error message 
-/// @return number of points if success, MALFORMED_ROW if there are any inappropriate characters
-int checkAndCalculatePoints(char points_array[], char* path)
+/// @brief This function halves the array of students once only a quarter of it is used. Shrinking at a quarter and not
+/// at a half keeps alternating enrol and remove from reallocating every time. If a reallocation fails the arrays that
+/// have not shrunk are simply kept bigger.
+/// @param lecture lecture
+void shrinkStudentsIfSparse(Lecture* lecture)
 {
-  int index = 0;
-  for(; index < 4; index++)
-  {
-    if(points_array[index] == ',' || points_array[index] == '\0')
-    {
-      break;
-    }
-  }//index is now max 4
-  if(index == 0 || index >= 4)//if the ',' is first character or is not found/4th character
-  {
-    printf("Error: Invalid file: %s!\n", path);
-    return MALFORMED_ROW;
-  }
-  points_array[index] = '\0';//at the max 3th position we assign a null terminator so that atoi works properly
-  for(int current_index = 0; current_index < index; current_index++)
+  if(lecture->amount_students_ == 0)
   {
-    if(isdigit(points_array[current_index]) == 0)//we check whether the characters that we have are all numbers
-    {
-      printf("Error: Invalid file: %s!\n", path);
-      return MALFORMED_ROW;
-    }
+    free(lecture->students_);
+    free(lecture->points_);
+    free(lecture->grades_);
+    lecture->students_ = NULL;
+    lecture->points_ = NULL;
+    lecture->grades_ = NULL;
+    lecture->capacity_ = 0;
+    return;
   }
-  int number_points = atoi(points_array);//finally we assemble a number from an array of digits
-  if(number_points > 100 || number_points < 0)//check if it is in the allowed range
+  if(lecture->capacity_ > STUDENTS_INITIAL_CAPACITY && lecture->amount_students_ <= lecture->capacity_ / 4)
   {
-    printf("Error: Invalid file: %s!\n", path);
-    return MALFORMED_ROW;
+    reserveStudents(lecture, lecture->capacity_ / 2);
   }
-  return number_points;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function receives an array with characters that represent a grade. It checks whether these characters
-/// are valid, derives a grade as a number from them and then checks whether the grade is in the right range.
-/// @param grade_array array with characters that are responsible for the grade
-/// @param path file path string, is used to print the error message 
-/// @return grade if success, MALFORMED_ROW if row is malformed
-int checkAndCalculateGrade(char grade_array[], char* path)
+/// @brief This function returns the name of the student, which is either stored in the student or elsewhere.
+/// @param student student
+/// @return name of the student, a short name is only valid until the array of students changes
+char* studentsName(Student* student)
 {
-  if(grade_array[1] != '\n')
-  {
-    printf("Error: Invalid file: %s!\n", path);
-    return MALFORMED_ROW;
-  }
-  if(isdigit(grade_array[0]) == 0)
-  {
-    printf("Error: Invalid file: %s!\n", path);
-    return MALFORMED_ROW;
-  }
-  int grade = grade_array[0] - '0';
-  if(grade > 5 || grade < 0)
+  if(student->length_ != LONG_NAME)
   {
-    printf("Error: Invalid file: %s!\n", path);
-    return MALFORMED_ROW;
+    return student->name_;
   }
-  return grade;
+  char* long_name = NULL;
+  memcpy(&long_name, student->name_, sizeof(char*));
+  return long_name;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function frees students.
-/// @param lecture lecture where the students are
-void freeStudents(Lecture* lecture)
+/// @brief This function stores the name in the student. A short name is copied into the student, a long name is either
+/// copied into the arena of the lecture or, if it is already stored in a name block, only its address is stored.
+/// @param lecture lecture, it is only used if a long name is copied
+/// @param student student
+/// @param name name, it does not have to end with '\0' if it is copied
+/// @param length length of the name
+/// @param copy_long_name false if a long name is kept where it is, it must end with '\0' then
+/// @return 0 on success, MEMORY_ERROR if allocation failed
+int storeStudentsName(Lecture* lecture, Student* student, char* name, int length, bool copy_long_name)
 {
-  if(lecture->students_ == NULL)
+  if(length < SHORT_NAME_SIZE)
   {
-    return;
+    memcpy(student->name_, name, length);
+    student->name_[length] = '\0';
+    student->length_ = length;
+    return 0;
   }
-  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  char* long_name = name;
+  if(copy_long_name)
   {
-    free((lecture->students_ + student_index)->name_);
-    (lecture->students_ + student_index)->name_ = NULL;
+    long_name = allocateFromArena(lecture, length + 1);
+    if(long_name == NULL)
+    {
+      return MEMORY_ERROR;
+    }
+    memcpy(long_name, name, length);
+    long_name[length] = '\0';
   }
-  free(lecture->students_);
-  lecture->students_ = NULL;//to know that it's freed
+  memcpy(student->name_, &long_name, sizeof(char*));
+  student->length_ = LONG_NAME;
+  return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function frees the whole lecture.
-/// @param lecture lecture
-void freeLecture(Lecture* lecture)
+/// @brief This function compares the name of the student with a name. Short names are compared by length first, and a
+/// long name can never be equal to a short one.
+/// @param student student
+/// @param name name
+/// @param length length of the name
+/// @return true if the student has this name
+bool studentHasName(Student* student, char* name, int length)
 {
-  if(lecture == NULL)
+  if(student->length_ != LONG_NAME)
   {
+    return student->length_ == length && memcmp(student->name_, name, length) == 0;
+  }
+  return length >= SHORT_NAME_SIZE && strcmp(studentsName(student), name) == 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function calculates a hash of the name (FNV-1a), it is used to find a slot in the name index.
+/// @param name name of the student
+/// @return hash of the name
+unsigned int hashName(char* name)
+{
+  unsigned int hash = 2166136261u;
+  for(; *name != '\0'; name++)
+  {
+    hash ^= (unsigned char)*name;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function searches the name index for a name. Slots are probed one after another starting with the slot
+/// given by the hash until either the name or an empty slot is found.
+/// @param lecture lecture
+/// @param name name of the target student
+/// @return slot that contains the student with this name, or the empty slot where such a student would be placed
+int findNameSlot(Lecture* lecture, char* name)
+{
+  int mask = lecture->name_index_capacity_ - 1;
+  int slot = hashName(name) & mask;
+  int length = strlen(name);
+  while(lecture->name_index_[slot] != EMPTY_SLOT)
+  {
+    if(studentHasName(lecture->students_ + lecture->name_index_[slot], name, length))
+    {
+      return slot;
+    }
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function places an index of the student into the first empty slot of its probe sequence. It does not
+/// grow the index, so the caller has to make sure there is enough space.
+/// @param lecture lecture
+/// @param student_index index of the student in the students array
+void placeIntoNameIndex(Lecture* lecture, int student_index)
+{
+  int mask = lecture->name_index_capacity_ - 1;
+  int slot = hashName(studentsName(lecture->students_ + student_index)) & mask;
+  while(lecture->name_index_[slot] != EMPTY_SLOT)
+  {
+    slot = (slot + 1) & mask;
+  }
+  lecture->name_index_[slot] = student_index;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function empties the name index and inserts first amount_students students of the lecture into it
+/// again. It does not allocate anything.
+/// @param lecture lecture
+/// @param amount_students amount of students that are already stored in the array and have to be indexed
+void refillNameIndex(Lecture* lecture, int amount_students)
+{
+  for(int slot = 0; slot < lecture->name_index_capacity_; slot++)
+  {
+    lecture->name_index_[slot] = EMPTY_SLOT;
+  }
+  for(int student_index = 0; student_index < amount_students; student_index++)
+  {
+    placeIntoNameIndex(lecture, student_index);
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function allocates a new name index with the given capacity and inserts first amount_students students
+/// of the lecture into it. The old index is freed only if the allocation was successful.
+/// @param lecture lecture
+/// @param capacity new capacity, must be a power of two
+/// @param amount_students amount of students that are already stored in the array and have to be indexed
+/// @return 0 on success, MEMORY_ERROR if allocation failed
+int rebuildNameIndex(Lecture* lecture, int capacity, int amount_students)
+{
+  int* name_index = malloc(capacity * sizeof(int));
+  if(name_index == NULL)
+  {
+    return MEMORY_ERROR;
+  }
+  free(lecture->name_index_);
+  lecture->name_index_ = name_index;
+  lecture->name_index_capacity_ = capacity;
+  refillNameIndex(lecture, amount_students);
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function calculates how big the name index has to be for a certain amount of students. The index is
+/// kept at most half full, so that the probe sequences stay short.
+/// @param lecture lecture
+/// @param amount_students amount of students
+/// @return current capacity if it is enough, otherwise the current capacity doubled as many times as needed
+int nameIndexCapacityFor(Lecture* lecture, int amount_students)
+{
+  int capacity = lecture->name_index_capacity_ == 0 ? NAME_INDEX_INITIAL_CAPACITY : lecture->name_index_capacity_;
+  while(amount_students * 2 > capacity)
+  {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function makes sure that the name index can hold a certain amount of students without growing. All
+/// students that are currently in the lecture stay indexed.
+/// @param lecture lecture
+/// @param amount_students amount of students
+/// @return 0 on success, MEMORY_ERROR if allocation failed
+int reserveNameIndex(Lecture* lecture, int amount_students)
+{
+  int capacity = nameIndexCapacityFor(lecture, amount_students);
+  if(capacity == lecture->name_index_capacity_)
+  {
+    return 0;
+  }
+  return rebuildNameIndex(lecture, capacity, lecture->amount_students_);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function adds a student to the name index. If the index would become more than half full it is doubled
+/// and rebuilt.
+/// @param lecture lecture
+/// @param student_index index of the student, all students before it must already be in the index
+/// @return 0 on success, MEMORY_ERROR if allocation failed
+int insertIntoNameIndex(Lecture* lecture, int student_index)
+{
+  int capacity = nameIndexCapacityFor(lecture, student_index + 1);
+  if(capacity != lecture->name_index_capacity_)
+  {
+    return rebuildNameIndex(lecture, capacity, student_index + 1);
+  }
+  placeIntoNameIndex(lecture, student_index);
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function removes a student from the name index. The following slots of the cluster are shifted back so
+/// that no probe sequence gets broken. Indices of other students are not changed.
+/// @param lecture lecture
+/// @param student_index index of the student that is removed, its name must still be valid
+void removeFromNameIndex(Lecture* lecture, int student_index)
+{
+  if(lecture->name_index_ == NULL)
+  {
+    return;
+  }
+  int mask = lecture->name_index_capacity_ - 1;
+  int empty = findNameSlot(lecture, studentsName(lecture->students_ + student_index));
+  int slot = empty;
+  while(true)
+  {
+    slot = (slot + 1) & mask;
+    if(lecture->name_index_[slot] == EMPTY_SLOT)
+    {
+      break;
+    }
+    int home = hashName(studentsName(lecture->students_ + lecture->name_index_[slot])) & mask;
+    if(((slot - home) & mask) >= ((slot - empty) & mask))
+    {//the entry can be moved to the empty slot without becoming unreachable
+      lecture->name_index_[empty] = lecture->name_index_[slot];
+      empty = slot;
+    }
+  }
+  lecture->name_index_[empty] = EMPTY_SLOT;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function compares two indices of students, it is used to sort them with qsort.
+/// @param first first index
+/// @param second second index
+/// @return negative, 0 or positive value, like strcmp
+int compareIndices(const void* first, const void* second)
+{
+  return *(const int*)first - *(const int*)second;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function updates the name index after the students with the given indices were removed and the others
+/// were shifted to the left: every index is decreased by the amount of removed students before it, which is found by
+/// binary search.
+/// @param lecture lecture
+/// @param removed_indices sorted indices of the removed students
+/// @param amount_removed amount of removed students
+void renumberNameIndex(Lecture* lecture, int* removed_indices, int amount_removed)
+{
+  for(int slot = 0; slot < lecture->name_index_capacity_; slot++)
+  {
+    int student_index = lecture->name_index_[slot];
+    if(student_index == EMPTY_SLOT || student_index < removed_indices[0])
+    {
+      continue;
+    }
+    int low = 0;//amount of removed indices smaller than student_index is searched in [low, high]
+    int high = amount_removed;
+    while(low < high)
+    {
+      int middle = (low + high) / 2;
+      if(removed_indices[middle] < student_index)
+      {
+        low = middle + 1;
+      }
+      else
+      {
+        high = middle;
+      }
+    }
+    lecture->name_index_[slot] = student_index - low;
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function searches for a student in the lecture using the name of the student. It looks the name up in
+/// the name index, so it does not have to compare the name with every student.
+/// @param lecture lecture
+/// @param name name of the target student
+/// @return index of the target student in the students array of the lecture on success, NO_STUDENT on failure
+int studentNameInLecture(Lecture* lecture, char* name)
+{
+  if(lecture->name_index_ == NULL)
+  {
+    return NO_STUDENT;
+  }
+  int student_index = lecture->name_index_[findNameSlot(lecture, name)];
+  if(student_index == EMPTY_SLOT)
+  {
+    return NO_STUDENT;
+  }
+  return student_index;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks the first length characters of the name of the student. Name must be alphabetic.
+/// It does not print anything, so it can also be used while a file is parsed by several threads.
+/// @param students_name characters to be checked, do not have to be terminated with '\0'
+/// @param length amount of characters
+/// @return true if name is valid, false if name is invalid
+bool validStudentsName(char* students_name, int length)
+{
+  for(int character_index = 0; character_index < length; character_index++)
+  {
+    if(isalpha((unsigned char)*(students_name + character_index)) == 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks the name of the student. Name must be alphabetic.
+/// @param students_name string to be checked
+/// @return 0 if name is valid, INCORRECT_STUDENTS_NAME is name is invalid
+int checkStudentsName(char* students_name)
+{
+  if(!validStudentsName(students_name, strlen(students_name)))
+  {
+    printf("Error: Name contains invalid characters!\n");
+    return INCORRECT_STUDENTS_NAME;
+  }
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function takes an array of characters that contains points and other symbols. It distinguishes
+/// characters that are relevant for the points and converts them to the number. It also checks whether the points are
+/// in a range from 0 to 100. It does not print anything, the caller reports a malformed row.
+/// @param points_array array where point characters are awaited to be
+/// @return number of points if success, MALFORMED_ROW if there are any inappropriate characters
+int checkAndCalculatePoints(char points_array[])
+{
+  int index = 0;
+  for(; index < 4; index++)
+  {
+    if(points_array[index] == ',' || points_array[index] == '\0')
+    {
+      break;
+    }
+  }//index is now max 4
+  if(index == 0 || index >= 4)//if the ',' is first character or is not found/4th character
+  {
+    return MALFORMED_ROW;
+  }
+  points_array[index] = '\0';//at the max 3th position we assign a null terminator so that atoi works properly
+  for(int current_index = 0; current_index < index; current_index++)
+  {
+    if(isdigit(points_array[current_index]) == 0)//we check whether the characters that we have are all numbers
+    {
+      return MALFORMED_ROW;
+    }
+  }
+  int number_points = atoi(points_array);//finally we assemble a number from an array of digits
+  if(number_points > 100 || number_points < 0)//check if it is in the allowed range
+  {
+    return MALFORMED_ROW;
+  }
+  return number_points;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function receives an array with characters that represent a grade. It checks whether these characters
+/// are valid, derives a grade as a number from them and then checks whether the grade is in the right range. It does
+/// not print anything, the caller reports a malformed row.
+/// @param grade_array array with characters that are responsible for the grade
+/// @return grade if success, MALFORMED_ROW if row is malformed
+int checkAndCalculateGrade(char grade_array[])
+{
+  if(grade_array[1] != '\n')
+  {
+    return MALFORMED_ROW;
+  }
+  if(isdigit(grade_array[0]) == 0)
+  {
+    return MALFORMED_ROW;
+  }
+  int grade = grade_array[0] - '0';
+  if(grade > 5 || grade < 0)
+  {
+    return MALFORMED_ROW;
+  }
+  return grade;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function drops the cached sorted orders of print --sort, because students were enrolled or removed or
+/// their points have changed. The order by names does not depend on points, so it is kept if only points changed.
+/// @param lecture lecture
+/// @param names_changed whether students were enrolled or removed
+void invalidateSortedOrders(Lecture* lecture, bool names_changed)
+{
+  free(lecture->points_order_.indices_);
+  lecture->points_order_.indices_ = NULL;
+  lecture->points_order_.length_ = 0;
+  if(names_changed)
+  {
+    free(lecture->names_order_.indices_);
+    lecture->names_order_.indices_ = NULL;
+    lecture->names_order_.length_ = 0;
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function stops tracking changed points for export --incremental, because students were enrolled or
+/// removed or the grades have changed, so the snapshot has to be written whole again.
+/// @param lecture lecture
+void forgetSnapshot(Lecture* lecture)
+{
+  free(lecture->changed_points_);
+  lecture->changed_points_ = NULL;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function writes the records the journal has buffered to its file and makes them durable with fsync,
+/// so that they survive a crash of the system and not only of the program.
+/// @param journal journal, its file must be open
+/// @return true on success
+bool syncJournal(Journal* journal)
+{
+  journal->unsynced_records_ = 0;
+  return fflush(journal->file_) == 0 && fsync(fileno(journal->file_)) == 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function syncs and closes the journal, its file stays on the disk for the next load of the lecture.
+/// @param journal journal
+void closeJournal(Journal* journal)
+{
+  if(journal->file_ != NULL)
+  {
+    syncJournal(journal);
+    fclose(journal->file_);
+    journal->file_ = NULL;
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function frees students, the name index and the sorted orders. Names are not freed one by one, they
+/// live either in the students or in the arena, so the students do not have to be visited at all.
+/// @param lecture lecture where the students are
+void freeStudents(Lecture* lecture)
+{
+  invalidateSortedOrders(lecture, true);
+  free(lecture->name_index_);
+  lecture->name_index_ = NULL;
+  lecture->name_index_capacity_ = 0;
+  free(lecture->students_);
+  free(lecture->points_);
+  free(lecture->grades_);
+  lecture->students_ = NULL;//to know that it's freed
+  lecture->points_ = NULL;
+  lecture->grades_ = NULL;
+  lecture->capacity_ = 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function frees the whole lecture. The arena is released block by block, and the blocks double in size,
+/// so this does not depend on the amount of students. The journal is closed, but its file stays.
+/// @param lecture lecture
+void freeLecture(Lecture* lecture)
+{
+  if(lecture == NULL)
+  {
+    return;
+  }
+  freeStudents(lecture);
+  forgetSnapshot(lecture);
+  closeJournal(&lecture->journal_);
+  while(lecture->name_blocks_ != NULL)
+  {
+    removeFirstNameBlock(lecture);
+  }
+  lecture->name_ = NULL;
+  free(lecture);
+  lecture = NULL;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function copies characters of the row into an array the same way fgets would do it: it stops after
+/// size - 1 characters or after the '\n', whatever comes first, and terminates the array with '\0'.
+/// @param array destination array, must be able to hold size characters
+/// @param size size of the array
+/// @param row row of the file, ends with '\n'
+/// @param position position in the row where copying starts
+/// @return amount of characters that were copied
+int copyFieldFromRow(char array[], int size, char* row, int position)
+{
+  int length = 0;
+  while(length < size - 1)
+  {
+    array[length] = row[position + length];
+    length++;
+    if(array[length - 1] == '\n')
+    {
+      break;
+    }
+  }
+  array[length] = '\0';
+  return length;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function parses one row of the file without changing it. Name is everything before the first ',', then
+/// points and grade are cut out of the row exactly the way the old fgets based reader did it and are checked with
+/// checkAndCalculatePoints and checkAndCalculateGrade, so the same rows are considered malformed. It does not print
+/// anything, see printRowError.
+/// @param row row of the file, ends with '\n'
+/// @param row_length length of the row including '\n'
+/// @param name_length length of the name, which starts at the beginning of the row
+/// @param points points of the student
+/// @param grade grade of the student
+/// @return 0 if success, INCORRECT_STUDENTS_NAME if the name is invalid, MALFORMED_ROW if the row is invalid
+int parseRowFields(char* row, int row_length, int* name_length, int* points, int* grade)
+{
+  char* comma = memchr(row, ',', row_length);
+  if(comma == NULL)
+  {
+    return MALFORMED_ROW;
+  }
+  *name_length = comma - row;
+  if(!validStudentsName(row, *name_length))
+  {
+    return INCORRECT_STUDENTS_NAME;
+  }
+  int position = *name_length + 1;//skipping ','
+  char points_array[4] = {0};//3 for numbers one for ','
+  position += copyFieldFromRow(points_array, 4, row, position);
+  *points = checkAndCalculatePoints(points_array);
+  if(*points == MALFORMED_ROW)
+  {
+    return MALFORMED_ROW;
+  }
+  if(*points < 10)
+  {
+    position--;
+  }
+  else if(*points == 100)
+  {
+    position++;
+  }//now we are at the character after the ','
+  if(position >= row_length)//grade would have to be in the next row
+  {
+    return MALFORMED_ROW;
+  }
+  char grade_array[3] = {0};
+  copyFieldFromRow(grade_array, 3, row, position);
+  *grade = checkAndCalculateGrade(grade_array);
+  if(*grade == MALFORMED_ROW)
+  {
+    return MALFORMED_ROW;
+  }
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function prints the error message for a row that parseRowFields has rejected.
+/// @param error value returned by parseRowFields
+/// @param path path to the file
+void printRowError(int error, char* path)
+{
+  if(error == INCORRECT_STUDENTS_NAME)
+  {
+    printf("Error: Name contains invalid characters!\n");
+    return;
+  }
+  printf("Error: Invalid file: %s!\n", path);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function parses one row of the file with parseRowFields and appends the student to the lecture. The
+/// array of students must already have space for one more student.
+/// @param lecture lecture
+/// @param row row of the file, ends with '\n'
+/// @param row_length length of the row including '\n'
+/// @param path path to the file, is used to print error message
+/// @return 0 if success, MALFORMED_ROW if the row is invalid or the name is not unique, MEMORY_ERROR if allocation
+/// failed
+int parseStudentRow(Lecture* lecture, char* row, int row_length, char* path)
+{
+  int current_student = lecture->amount_students_;
+  int student_name_length = 0;
+  int points = 0;
+  int grade = 0;
+  int result = parseRowFields(row, row_length, &student_name_length, &points, &grade);
+  if(result != 0)
+  {
+    printRowError(result, path);
+    return MALFORMED_ROW;
+  }
+  Student* student = lecture->students_ + current_student;//not in the name index yet, so it cannot be found
+  if(storeStudentsName(lecture, student, row, student_name_length, true) == MEMORY_ERROR)
+  {
+    return MEMORY_ERROR;
+  }
+  if(studentNameInLecture(lecture, studentsName(student)) != NO_STUDENT)
+  {//all previous rows are already in the name index, so one lookup per row is enough to find duplicates
+    printf("Error: Invalid file: %s, name in row %d is not unique!\n", path, current_student + 1);
+    return MALFORMED_ROW;
+  }
+  lecture->points_[current_student] = points;
+  lecture->grades_[current_student] = grade;
+  lecture->amount_students_++;
+  return insertIntoNameIndex(lecture, current_student);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function reads information from the file, checks it and then assigns it to the lecture. The file is
+/// read only once in big blocks, every complete row of the block is parsed with parseStudentRow, and an unfinished row
+/// at the end of the block is moved to the beginning of the buffer to be completed by the next block. The array of
+/// students grows geometrically while reading. Characters after the last '\n' do not form a row and are ignored. Every
+/// student is added to the name index right away, which is also used to detect duplicate names in a single pass.
+/// @param file file, where the data is taken from
+/// @param lecture lecture
+/// @param path path to that file, is used to print error message
+/// @return 0 if success, MALFORMED_ROW if the data in file is invalid or a name is not unique, MEMORY_ERROR if
+/// allocation failed
+int writeFromFileToLecture(FILE* file, Lecture* lecture, char* path)
+{
+  int buffer_size = READ_BUFFER_SIZE;
+  char* buffer = malloc(buffer_size);
+  if(buffer == NULL)
+  {
+    freeLecture(lecture);
+    return MEMORY_ERROR;
+  }
+  int filled = 0;//characters in the buffer, the unfinished row is always at the beginning
+  int result = 0;
+  while(result == 0)
+  {
+    if(filled == buffer_size)//one row does not fit into the buffer
+    {
+      char* bigger_buffer = realloc(buffer, buffer_size * 2);
+      if(bigger_buffer == NULL)
+      {
+        result = MEMORY_ERROR;
+        break;
+      }
+      buffer = bigger_buffer;
+      buffer_size *= 2;
+    }
+    int read = fread(buffer + filled, 1, buffer_size - filled, file);
+    if(read == 0)
+    {
+      break;
+    }
+    int searched = filled;//the unfinished row does not contain '\n', no need to search there again
+    filled += read;
+    int row_start = 0;
+    char* newline = NULL;
+    while(result == 0 && (newline = memchr(buffer + searched, '\n', filled - searched)) != NULL)
+    {
+      result = growStudentsIfFull(lecture);
+      if(result != 0)
+      {
+        break;
+      }
+      int row_end = newline - buffer + 1;
+      result = parseStudentRow(lecture, buffer + row_start, row_end - row_start, path);
+      row_start = row_end;
+      searched = row_end;
+    }
+    memmove(buffer, buffer + row_start, filled - row_start);
+    filled -= row_start;
+  }
+  free(buffer);
+  if(result != 0)
+  {
+    freeLecture(lecture);
+  }
+  return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function parses all rows of one chunk of the mapped file. It is the body of a loading thread, so it
+/// only touches its own chunk: students are collected in the own array of the chunk and names are copied into the part
+/// of the name block that has the same offset as the chunk, which is big enough because every name together with its
+/// '\0' is shorter than its row. Parsing stops at the first invalid row, nothing is printed.
+/// @param argument chunk of the file (LoadChunk)
+/// @return NULL
+void* parseChunk(void* argument)
+{
+  LoadChunk* chunk = argument;
+  int capacity = 0;
+  long row_start = 0;
+  char* names_position = chunk->names_;
+  char* newline = NULL;
+  while((newline = memchr(chunk->rows_ + row_start, '\n', chunk->length_ - row_start)) != NULL)
+  {
+    if(chunk->amount_students_ == capacity)
+    {
+      int new_capacity = capacity == 0 ? STUDENTS_INITIAL_CAPACITY : capacity * 2;
+      if(reserveColumns(&chunk->students_, &chunk->points_, &chunk->grades_, &capacity, new_capacity) == MEMORY_ERROR)
+      {
+        chunk->error_ = MEMORY_ERROR;
+        return NULL;
+      }
+    }
+    long row_end = newline - chunk->rows_ + 1;
+    Student* student = chunk->students_ + chunk->amount_students_;
+    int name_length = 0;
+    int points = 0;
+    int grade = 0;
+    chunk->error_ = parseRowFields(chunk->rows_ + row_start, row_end - row_start, &name_length, &points, &grade);
+    if(chunk->error_ != 0)
+    {
+      return NULL;
+    }
+    chunk->points_[chunk->amount_students_] = points;
+    chunk->grades_[chunk->amount_students_] = grade;
+    if(name_length < SHORT_NAME_SIZE)
+    {
+      storeStudentsName(NULL, student, chunk->rows_ + row_start, name_length, false);
+    }
+    else
+    {
+      memcpy(names_position, chunk->rows_ + row_start, name_length);
+      names_position[name_length] = '\0';
+      storeStudentsName(NULL, student, names_position, name_length, false);
+      names_position += name_length + 1;
+      chunk->long_names_ = true;
+    }
+    chunk->amount_students_++;
+    row_start = row_end;
+  }
+  return NULL;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function splits the mapped file into chunks that end right after a '\n', so that no row is cut.
+/// @param chunks array of chunks to fill
+/// @param amount_chunks amount of chunks, some of them can stay empty if the file has only a few rows
+/// @param mapping mapped file
+/// @param file_size size of the file
+/// @param names name block, as big as the file
+void splitIntoChunks(LoadChunk* chunks, int amount_chunks, char* mapping, long file_size, char* names)
+{
+  long chunk_start = 0;
+  for(int chunk_index = 0; chunk_index < amount_chunks; chunk_index++)
+  {
+    long chunk_end = file_size;//the rest after the last '\n' is ignored by parseChunk
+    if(chunk_index < amount_chunks - 1)
+    {
+      long target = file_size * (chunk_index + 1) / amount_chunks;
+      if(target < chunk_start)
+      {
+        target = chunk_start;
+      }
+      char* newline = memchr(mapping + target, '\n', file_size - target);
+      if(newline != NULL)
+      {
+        chunk_end = newline - mapping + 1;
+      }
+    }
+    (chunks + chunk_index)->rows_ = mapping + chunk_start;
+    (chunks + chunk_index)->length_ = chunk_end - chunk_start;
+    (chunks + chunk_index)->names_ = names + chunk_start;
+    (chunks + chunk_index)->students_ = NULL;
+    (chunks + chunk_index)->points_ = NULL;
+    (chunks + chunk_index)->grades_ = NULL;
+    (chunks + chunk_index)->amount_students_ = 0;
+    (chunks + chunk_index)->long_names_ = false;
+    (chunks + chunk_index)->error_ = 0;
+    chunk_start = chunk_end;
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function appends the students of the parsed chunks to the lecture in the file order and adds them to
+/// the name index, which also detects duplicate names. Because the chunks are merged in order and every chunk stopped
+/// at its first invalid row, the error that is reported is always the first one in the file, no matter how many threads
+/// were used.
+/// @param lecture lecture
+/// @param chunks parsed chunks
+/// @param amount_chunks amount of chunks
+/// @param path path to the file, is used to print error message
+/// @return 0 if success, MALFORMED_ROW if a row is invalid or a name is not unique, MEMORY_ERROR if allocation failed
+int mergeChunks(Lecture* lecture, LoadChunk* chunks, int amount_chunks, char* path)
+{
+  int amount_students = 0;
+  for(int chunk_index = 0; chunk_index < amount_chunks; chunk_index++)
+  {
+    amount_students += (chunks + chunk_index)->amount_students_;
+  }
+  if(amount_students > 0 && reserveStudents(lecture, amount_students) == MEMORY_ERROR)
+  {
+    return MEMORY_ERROR;
+  }
+  for(int chunk_index = 0; chunk_index < amount_chunks; chunk_index++)
+  {
+    LoadChunk* chunk = chunks + chunk_index;
+    for(int student_index = 0; student_index < chunk->amount_students_; student_index++)
+    {
+      int current_student = lecture->amount_students_;
+      if(studentNameInLecture(lecture, studentsName(chunk->students_ + student_index)) != NO_STUDENT)
+      {
+        printf("Error: Invalid file: %s, name in row %d is not unique!\n", path, current_student + 1);
+        return MALFORMED_ROW;
+      }
+      *(lecture->students_ + current_student) = *(chunk->students_ + student_index);
+      lecture->points_[current_student] = chunk->points_[student_index];
+      lecture->grades_[current_student] = chunk->grades_[student_index];
+      lecture->amount_students_++;
+      if(insertIntoNameIndex(lecture, current_student) == MEMORY_ERROR)
+      {
+        return MEMORY_ERROR;
+      }
+    }
+    if(chunk->error_ == MEMORY_ERROR)
+    {
+      return MEMORY_ERROR;
+    }
+    if(chunk->error_ != 0)
+    {
+      printRowError(chunk->error_, path);
+      return MALFORMED_ROW;
+    }
+  }
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function maps the whole file into memory and parses the rows in place, without copying them into a
+/// read buffer. The file is split into one chunk per thread and every chunk is parsed by parseChunk on its own thread,
+/// then the chunks are merged in the file order. Short names are copied into the students, long names are not allocated
+/// one by one, they are copied into one name block of the lecture, which is as big as the file and is released right
+/// away if there are no long names. Characters after the last '\n' do not form a row and are ignored.
+/// @param file file, where the data is taken from
+/// @param lecture lecture
+/// @param path path to that file, is used to print error message
+/// @param amount_threads amount of threads that parse the file, 1 parses it on the calling thread
+/// @return 0 if success, MALFORMED_ROW if the data in file is invalid or a name is not unique, MEMORY_ERROR if
+/// allocation failed, FILE_ERROR if the file could not be mapped
+int mapFileToLecture(FILE* file, Lecture* lecture, char* path, int amount_threads)
+{
+  struct stat file_status;
+  if(fstat(fileno(file), &file_status) != 0)
+  {
+    printf("Error: Cannot open file: %s!\n", path);
+    freeLecture(lecture);
+    return FILE_ERROR;
+  }
+  long file_size = file_status.st_size;
+  if(file_size == 0)//mmap does not accept an empty mapping
+  {
+    return 0;
+  }
+  char* mapping = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+  if(mapping == MAP_FAILED)
+  {
+    printf("Error: Cannot open file: %s!\n", path);
+    freeLecture(lecture);
+    return FILE_ERROR;
+  }
+  posix_madvise(mapping, file_size, POSIX_MADV_SEQUENTIAL);
+  NameBlock* block = addNameBlock(lecture, file_size);
+  LoadChunk* chunks = calloc(amount_threads, sizeof(LoadChunk));
+  pthread_t* threads = calloc(amount_threads, sizeof(pthread_t));
+  if(block == NULL || chunks == NULL || threads == NULL)
+  {
+    free(chunks);
+    free(threads);
+    munmap(mapping, file_size);
+    freeLecture(lecture);
+    return MEMORY_ERROR;
+  }
+  splitIntoChunks(chunks, amount_threads, mapping, file_size, block->names_);
+  int started_threads = 1;//the first chunk is always parsed on the calling thread
+  for(; started_threads < amount_threads; started_threads++)
+  {
+    if(pthread_create(threads + started_threads, NULL, parseChunk, chunks + started_threads) != 0)
+    {
+      break;
+    }
+  }
+  for(int chunk_index = started_threads; chunk_index < amount_threads; chunk_index++)
+  {
+    parseChunk(chunks + chunk_index);//if a thread could not be created its chunk is parsed here
+  }
+  parseChunk(chunks);
+  for(int thread_index = 1; thread_index < started_threads; thread_index++)
+  {
+    pthread_join(*(threads + thread_index), NULL);
+  }
+  int result = mergeChunks(lecture, chunks, amount_threads, path);
+  bool long_names = false;
+  for(int chunk_index = 0; chunk_index < amount_threads; chunk_index++)
+  {
+    long_names = long_names || (chunks + chunk_index)->long_names_;
+    free((chunks + chunk_index)->students_);
+    free((chunks + chunk_index)->points_);
+    free((chunks + chunk_index)->grades_);
+  }
+  free(chunks);
+  free(threads);
+  munmap(mapping, file_size);
+  if(result != 0)
+  {
+    freeLecture(lecture);
+    return result;
+  }
+  if(!long_names)//all names were copied into the students
+  {
+    removeFirstNameBlock(lecture);
+  }
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function adds bytes to an Adler-32 checksum, which is used by binary snapshots. The checksum of data
+/// does not depend on how it is split into parts, so the writer can checksum its buffer whenever it is flushed.
+/// @param checksum checksum of the bytes before, 1 at the beginning
+/// @param data bytes to add
+/// @param length amount of the bytes
+/// @return checksum including the bytes
+uint32_t updateChecksum(uint32_t checksum, unsigned char* data, size_t length)
+{
+  uint32_t low = checksum & 0xFFFF;
+  uint32_t high = checksum >> 16;
+  while(length > 0)
+  {
+    size_t block = length < CHECKSUM_BLOCK ? length : CHECKSUM_BLOCK;
+    for(size_t index = 0; index < block; index++)
+    {
+      low += data[index];
+      high += low;
+    }
+    low %= CHECKSUM_MODULUS;
+    high %= CHECKSUM_MODULUS;
+    data += block;
+    length -= block;
+  }
+  return (high << 16) | low;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function changes an Adler-32 checksum for one byte that was overwritten, without the other bytes: the
+/// first sum changes by the difference of the bytes and the second one by the difference times the amount of bytes
+/// from this byte to the end.
+/// @param checksum checksum of the data with the old byte
+/// @param length length of the data
+/// @param position position of the byte in the data
+/// @param old_byte old value of the byte
+/// @param new_byte new value of the byte
+/// @return checksum of the data with the new byte
+uint32_t patchChecksum(uint32_t checksum, uint64_t length, uint64_t position, int old_byte, int new_byte)
+{
+  int64_t difference = new_byte - old_byte;
+  int64_t low = ((checksum & 0xFFFF) + difference) % CHECKSUM_MODULUS;
+  int64_t high = ((checksum >> 16) + (int64_t)((length - position) % CHECKSUM_MODULUS) * difference) %
+                 CHECKSUM_MODULUS;
+  low += low < 0 ? CHECKSUM_MODULUS : 0;
+  high += high < 0 ? CHECKSUM_MODULUS : 0;
+  return ((uint32_t)high << 16) | (uint32_t)low;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function finds out whether a file is a binary snapshot written by export --binary instead of a csv
+/// file, by its first four bytes. The file is read from the beginning again afterwards.
+/// @param file opened file
+/// @return true if the file starts with the snapshot magic
+bool isSnapshot(FILE* file)
+{
+  uint32_t magic = 0;
+  bool snapshot = fread(&magic, sizeof(magic), 1, file) == 1 && magic == SNAPSHOT_MAGIC;
+  rewind(file);
+  return snapshot;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks the header of a snapshot against the size of the file and the checksum of the rest.
+/// @param snapshot whole snapshot
+/// @param size size of the snapshot in bytes
+/// @param header the header is copied here
+/// @return true if the header is valid and the checksum matches
+bool validSnapshotHeader(char* snapshot, long size, SnapshotHeader* header)
+{
+  if(size < (long)sizeof(SnapshotHeader))
+  {
+    return false;
+  }
+  memcpy(header, snapshot, sizeof(SnapshotHeader));
+  uint64_t body_size = 6 * (uint64_t)header->amount_students_ + header->names_size_;//points, grade and offset
+  return header->version_ == SNAPSHOT_VERSION && header->amount_students_ <= INT32_MAX &&
+         header->names_size_ <= UINT32_MAX && (header->amount_students_ > 0 || header->names_size_ == 0) &&
+         body_size == (uint64_t)size - sizeof(SnapshotHeader) &&
+         updateChecksum(1, (unsigned char*)snapshot + sizeof(SnapshotHeader), body_size) == header->checksum_;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function loads a binary snapshot written by export --binary. The whole file is read with one fread
+/// into a temporary buffer, then a single pass checks every student the same way a csv row is checked: points from 0
+/// to 100 (checkAndCalculatePoints), a grade from 0 to 5 (checkAndCalculateGrade), a name of letters only that is
+/// unique, and the names have to follow each other in the blob exactly as the offsets say. Nothing is parsed: short
+/// names are copied into the students, long names into the arena, and the points and grades columns are copied as a
+/// whole, so the buffer is freed at the end and the lecture keeps only what it uses.
+/// @param file file, where the data is taken from
+/// @param lecture lecture
+/// @param path path to that file, is used to print error message
+/// @return 0 if success, MALFORMED_ROW if the snapshot is damaged or a student is invalid, MEMORY_ERROR if allocation
+/// failed, FILE_ERROR if the file could not be read
+int loadSnapshot(FILE* file, Lecture* lecture, char* path)
+{
+  struct stat file_status;
+  char* snapshot = NULL;
+  if(fstat(fileno(file), &file_status) != 0 || (snapshot = malloc(file_status.st_size + 1)) == NULL ||
+     fread(snapshot, 1, file_status.st_size, file) != (size_t)file_status.st_size)
+  {
+    printf(snapshot == NULL ? "Error: Cannot open file: %s!\n" : "Error: Invalid file: %s!\n", path);
+    free(snapshot);
+    freeLecture(lecture);
+    return snapshot == NULL ? MEMORY_ERROR : FILE_ERROR;
+  }
+  SnapshotHeader header;
+  if(!validSnapshotHeader(snapshot, file_status.st_size, &header))
+  {
+    printf("Error: Invalid file: %s!\n", path);
+    free(snapshot);
+    freeLecture(lecture);
+    return MALFORMED_ROW;
+  }
+  int amount_students = header.amount_students_;
+  uint8_t* points = (uint8_t*)snapshot + sizeof(SnapshotHeader);
+  uint8_t* grades = points + amount_students;
+  char* offsets = (char*)grades + amount_students;
+  char* names = offsets + 4 * (long)amount_students;
+  if(amount_students > 0 && (reserveStudents(lecture, amount_students) == MEMORY_ERROR ||
+                             reserveNameIndex(lecture, amount_students) == MEMORY_ERROR))
+  {
+    free(snapshot);
+    freeLecture(lecture);
+    return MEMORY_ERROR;
+  }
+  int result = 0;
+  for(int student_index = 0; student_index < amount_students && result == 0; student_index++)
+  {
+    uint32_t offset = 0;
+    uint32_t next_offset = header.names_size_;
+    memcpy(&offset, offsets + 4 * (long)student_index, sizeof(offset));
+    if(student_index + 1 < amount_students)
+    {
+      memcpy(&next_offset, offsets + 4 * (long)(student_index + 1), sizeof(next_offset));
+    }
+    int length = next_offset - offset - 1;
+    if(points[student_index] > MAX_POINTS || grades[student_index] > 5 || (student_index == 0 && offset != 0) ||
+       (uint64_t)offset + 1 >= next_offset || next_offset > header.names_size_ || names[next_offset - 1] != '\0')
+    {//the names have to fill the blob without gaps, a '\0' inside of a name is found by validStudentsName
+      printf("Error: Invalid file: %s!\n", path);
+      result = MALFORMED_ROW;
+    }
+    else if(!validStudentsName(names + offset, length))
+    {
+      printRowError(INCORRECT_STUDENTS_NAME, path);
+      result = MALFORMED_ROW;
+    }
+    else
+    {
+      int slot = findNameSlot(lecture, names + offset);//where the name is not found, the student is placed
+      if(lecture->name_index_[slot] != EMPTY_SLOT)
+      {
+        printf("Error: Invalid file: %s, name in row %d is not unique!\n", path, student_index + 1);
+        result = MALFORMED_ROW;
+        break;
+      }
+      if(storeStudentsName(lecture, lecture->students_ + student_index, names + offset, length, true) == MEMORY_ERROR)
+      {
+        result = MEMORY_ERROR;
+        break;
+      }
+      lecture->amount_students_++;
+      lecture->name_index_[slot] = student_index;
+    }
+  }
+  if(result == 0 && amount_students > 0)
+  {
+    memcpy(lecture->points_, points, amount_students);
+    memcpy(lecture->grades_, grades, amount_students);
+  }
+  free(snapshot);
+  if(result != 0)
+  {
+    freeLecture(lecture);
+  }
+  return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function fills the points histogram of a loaded lecture and marks its grades as loaded if any student
+/// has a grade.
+/// @param lecture lecture
+void countLoadedStudents(Lecture* lecture)
+{
+  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  {
+    lecture->points_histogram_[lecture->points_[student_index]]++;
+    if(lecture->grades_[student_index] != 0)
+    {
+      lecture->grades_state_ = LOADED_GRADES;
+    }
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents command load. It opens a file, writes data from file to the lecture, closes file.
+/// A binary snapshot is recognised by its first bytes and loaded by loadSnapshot, whatever way of loading was chosen.
+/// @param path path to the file
+/// @param lecture lecture
+/// @param amount_threads 0 if the file is read, otherwise the file is memory-mapped (load --mmap) and parsed by this
+/// amount of threads (load --threads)
+/// @return 0 on success, FILE_ERROR if file has not opened, MEMORY_ERROR if allocation failed, 
+/// INCORRECT_LECTURE_NAME if the name is invalid, MALFORMED_ROW if data in the file is invalid
+int loadLecture(char* path, Lecture** lecture, int amount_threads)
+{
+  FILE* file = fopen(path, "r");
+  if(file == NULL)
+  {
+    printf("Error: Cannot open file: %s!\n", path);
+    return FILE_ERROR;
+  }
+  int name_length = 0;
+  char* lecture_name = getNameForLecture(path, &name_length);
+  int result = createLecture(lecture_name, name_length, lecture);
+  if(result == MEMORY_ERROR)
+  {
+    fclose(file);
+    return MEMORY_ERROR;
+  }
+  if(result == INCORRECT_LECTURE_NAME)
+  {
+    fclose(file);
+    return INCORRECT_LECTURE_NAME;
+  }
+  int writing_result = 0;
+  if(isSnapshot(file))
+  {
+    writing_result = loadSnapshot(file, *lecture, path);
+  }
+  else
+  {
+    writing_result = amount_threads == 0 ? writeFromFileToLecture(file, *lecture, path) :
+                                           mapFileToLecture(file, *lecture, path, amount_threads);
+  }
+  if(writing_result != 0)
+  {
+    fclose(file);
+    return writing_result;
+  }
+  fclose(file);
+  countLoadedStudents(*lecture);
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function decides what happens when no line could be read. In the batch mode the end of the input is the
+/// normal end of the program, interactively it is handled like a memory error.
+/// @param session session
+/// @return QUIT if the batch input has ended, MEMORY_ERROR otherwise
+int endOfInput(Session* session)
+{
+  if(session->batch_ && feof(session->reader_.input_))
+  {
+    return QUIT;
+  }
+  return MEMORY_ERROR;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function prints commands for a lecture mode.
+void lectureCommandsPrint(void)
+{
+  printf("\nPlease enter one of the following commands:\n");
+  printf("  enrol  - enrol new student to the lecture\n");
+  printf("  remove - remove a student from the lecture\n");
+  printf("  give   - give points to a student\n");
+  printf("  calc   - calculate the grades for every student\n");
+  printf("  print  - print the lecture\n");
+  printf("  export - export the lecture to a file\n");
+  printf("  memory - show the memory used by the lecture\n");
+  printf("  use    - switch to another open lecture\n");
+  printf("  close  - close the lecture\n");
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function calculates the Adler-32 checksum of a whole file.
+/// @param path path to the file
+/// @param checksum the checksum is written here
+/// @return true on success, false if the file could not be read
+bool fileChecksum(char* path, uint32_t* checksum)
+{
+  FILE* file = fopen(path, "rb");
+  if(file == NULL)
+  {
+    return false;
+  }
+  unsigned char buffer[READ_BUFFER_SIZE];
+  size_t length = 0;
+  *checksum = 1;
+  while((length = fread(buffer, 1, READ_BUFFER_SIZE, file)) > 0)
+  {
+    *checksum = updateChecksum(*checksum, buffer, length);
+  }
+  bool read = ferror(file) == 0;
+  fclose(file);
+  return read;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function starts a new empty journal for the report of the lecture. The first line of the journal holds
+/// the checksum of the report, so that a journal that was not yet replaced when the program ended after a new report
+/// was written is recognised as older than the report. The journal is synced and renamed into place like the report,
+/// then the old journal is closed.
+/// @param lecture lecture, it is the same as its report
+/// @param checksum checksum of the report
+/// @return 0 on success, FILE_ERROR if the file could not be created, WRITE_ERROR if it could not be written
+int startJournal(Lecture* lecture, uint32_t checksum)
+{
+  FILE* file = fopen(lecture->journal_temp_path_, "w");
+  if(file == NULL)
+  {
+    return FILE_ERROR;
+  }
+  bool written = fprintf(file, "A4 journal %u\n", (unsigned int)checksum) > 0 && fflush(file) == 0 &&
+                 fsync(fileno(file)) == 0;
+  if(!written || rename(lecture->journal_temp_path_, lecture->journal_path_) != 0)
+  {
+    fclose(file);
+    remove(lecture->journal_temp_path_);
+    return WRITE_ERROR;
+  }
+  closeJournal(&lecture->journal_);
+  lecture->journal_.file_ = file;
+  lecture->journal_.base_ = REPORT_BASE;
+  lecture->journal_.records_ = 0;
+  lecture->journal_.unsynced_records_ = 0;
+  lecture->journal_.failed_ = false;
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function starts the journal of a lecture on its base before the first change is written to it. The
+/// report is not written, the journal of a lecture that was loaded from its report is bound to the report as it is.
+/// Without a base, or if reports/ cannot be written, the changes are silently kept only in memory until the next
+/// export, as they always were.
+/// @param lecture lecture
+/// @return true if the journal was started
+bool openJournal(Lecture* lecture)
+{
+  Journal* journal = &lecture->journal_;
+  if(journal->failed_ || journal->base_ == NO_BASE)
+  {
+    return false;
+  }
+  uint32_t checksum = 1;
+  if(!fileChecksum(lecture->report_path_, &checksum) || startJournal(lecture, checksum) != 0)
+  {
+    journal->failed_ = true;
+    return false;
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function starts a record of a command that changes students in the journal of the lecture. A record is
+/// one line in the words of the command with all its students, "enrol <names>", "remove [--swap] <names>" or
+/// "give <points> <name> <points> <name>...", so a command is either replayed whole or not at all. The first record
+/// starts the journal on its base (see openJournal), nothing is written if it cannot be started.
+/// @param lecture lecture
+/// @param command command with the options
+/// @return true if the record has to be written, false if the journal is not started
+bool startJournalRecord(Lecture* lecture, char* command)
+{
+  if(lecture->journal_.file_ == NULL && !openJournal(lecture))
+  {
+    return false;
+  }
+  fputs(command, lecture->journal_.file_);
+  return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function adds a student to the started record, see startJournalRecord.
+/// @param lecture lecture
+/// @param points points that were given to the student, NULL for commands without points
+/// @param name name of the student
+void journalStudent(Lecture* lecture, int* points, char* name)
+{
+  if(points != NULL)
+  {
+    fprintf(lecture->journal_.file_, " %d", *points);
+  }
+  putc(' ', lecture->journal_.file_);
+  fputs(name, lecture->journal_.file_);
+  lecture->journal_.records_++;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function ends the started record, see startJournalRecord.
+/// @param lecture lecture
+void endJournalRecord(Lecture* lecture)
+{
+  putc('\n', lecture->journal_.file_);
+  lecture->journal_.unsynced_records_++;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents a command enrol. It checks the name of the student and whether there already is a
+/// student with such a name. Then it grows array of students if it is full, adds a new student there and initialises
+/// points and grade of that student.
+/// @param lecture lecture
+/// @param name name of the new student
+/// @return 0 on success, MEMORY_ERROR if (re)allocation failed, other values if name is invalid or name is not unique
+int enrol(Lecture* lecture, char* name)
+{
+  if(checkStudentsName(name) == INCORRECT_STUDENTS_NAME)
+  {
+    return INCORRECT_STUDENTS_NAME;
+  }
+  if(studentNameInLecture(lecture, name) != NO_STUDENT)
+  {
+    printf("Error: Student already exists, please enter another name!\n");
+    return NOT_UNIQUE_NAME;
+  }
+  if(growStudentsIfFull(lecture) == MEMORY_ERROR)
+  {
+    return MEMORY_ERROR;
+  }
+  Student* student = lecture->students_ + lecture->amount_students_;
+  if(storeStudentsName(lecture, student, name, strlen(name), true) == MEMORY_ERROR)
+  {
+    return MEMORY_ERROR;
+  }
+  lecture->points_[lecture->amount_students_] = 0;//we need to do that because realloc gives
+  lecture->grades_[lecture->amount_students_] = 0;// us new memory with random values in it
+  lecture->amount_students_++;
+  lecture->points_histogram_[0]++;
+  invalidateSortedOrders(lecture, true);
+  forgetSnapshot(lecture);
+  if(insertIntoNameIndex(lecture, lecture->amount_students_ - 1) == MEMORY_ERROR)
+  {
+    return MEMORY_ERROR;
+  }
+  if(startJournalRecord(lecture, "enrol"))
+  {
+    journalStudent(lecture, NULL, name);
+    endJournalRecord(lecture);
+  }
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function appends a student with the given name and no points to the lecture and adds it to the name
+/// index. There must be space for the student both in the array and in the index.
+/// @param lecture lecture
+/// @param name name of the student, a long name is not copied
+/// @param length length of the name
+void appendReservedStudent(Lecture* lecture, char* name, int length)
+{
+  storeStudentsName(lecture, lecture->students_ + lecture->amount_students_, name, length, false);
+  lecture->points_[lecture->amount_students_] = 0;
+  lecture->grades_[lecture->amount_students_] = 0;
+  lecture->amount_students_++;
+  placeIntoNameIndex(lecture, lecture->amount_students_ - 1);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function opens a file for reading and finds out its size, so that it can be read with one fread.
+/// @param path path to the file
+/// @param size size of the file in bytes
+/// @return opened file, NULL if it could not be opened
+FILE* openWithSize(char* path, long* size)
+{
+  FILE* file = fopen(path, "r");
+  struct stat file_status;
+  if(file == NULL || fstat(fileno(file), &file_status) != 0)
+  {
+    printf("Error: Cannot open file: %s!\n", path);
+    if(file != NULL)
+    {
+      fclose(file);
+    }
+    return NULL;
+  }
+  *size = file_status.st_size;
+  return file;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents a command enrol --from. It reads the whole roster file (one name per line, empty
+/// lines are skipped) into one name block, so long names are not copied or allocated one by one: every '\n' just
+/// becomes the '\0' of the name before it. Short names are copied into the students and the block is released if
+/// there are no long names. The array of students and the name index are reserved once for all names,
+/// then every name is checked and appended in a single pass; a name is not unique if it is already in the lecture or
+/// earlier in the roster. Either all students are enrolled or, if any name is wrong, none of them.
+/// @param lecture lecture
+/// @param path path to the roster file
+/// @return 0 on success, FILE_ERROR if the file could not be read, MEMORY_ERROR if allocation failed,
+/// INCORRECT_STUDENTS_NAME or NOT_UNIQUE_NAME if a name is wrong
+int enrolFromRoster(Lecture* lecture, char* path)
+{
+  long size = 0;
+  FILE* file = openWithSize(path, &size);
+  if(file == NULL)
+  {
+    return FILE_ERROR;
+  }
+  NameBlock* block = addNameBlock(lecture, size + 1);//+1 so that the last name always ends with '\n'
+  if(block == NULL)
+  {
+    fclose(file);
+    return MEMORY_ERROR;
+  }
+  size = fread(block->names_, 1, size, file);
+  fclose(file);
+  block->names_[size] = '\n';
+  int amount_names = 0;
+  for(char* newline = block->names_; (newline = memchr(newline, '\n', block->names_ + size + 1 - newline)) != NULL;
+      newline++)
+  {
+    amount_names++;
+  }
+  int old_amount_students = lecture->amount_students_;
+  int new_amount_students = old_amount_students + amount_names;
+  if((new_amount_students > lecture->capacity_ && reserveStudents(lecture, new_amount_students) == MEMORY_ERROR) ||
+     reserveNameIndex(lecture, new_amount_students) == MEMORY_ERROR)
+  {
+    removeFirstNameBlock(lecture);
+    return MEMORY_ERROR;
+  }
+  int result = 0;
+  bool long_names = false;
+  char* name = block->names_;
+  for(int line = 1; line <= amount_names; line++)
+  {
+    char* newline = memchr(name, '\n', block->names_ + size + 1 - name);
+    *newline = '\0';
+    char* current_name = name;
+    name = newline + 1;
+    if(newline == current_name)//empty line
+    {
+      continue;
+    }
+    if(!validStudentsName(current_name, newline - current_name))
+    {
+      printf("Error: Name in line %d of %s contains invalid characters!\n", line, path);
+      result = INCORRECT_STUDENTS_NAME;
+      break;
+    }
+    if(studentNameInLecture(lecture, current_name) != NO_STUDENT)
+    {
+      printf("Error: Student in line %d of %s already exists!\n", line, path);
+      result = NOT_UNIQUE_NAME;
+      break;
+    }
+    appendReservedStudent(lecture, current_name, newline - current_name);
+    long_names = long_names || newline - current_name >= SHORT_NAME_SIZE;
+  }
+  if(result != 0)
+  {
+    lecture->amount_students_ = old_amount_students;
+    refillNameIndex(lecture, old_amount_students);
+    removeFirstNameBlock(lecture);
+    return result;
+  }
+  lecture->points_histogram_[0] += lecture->amount_students_ - old_amount_students;
+  invalidateSortedOrders(lecture, true);
+  forgetSnapshot(lecture);
+  bool enrolled = lecture->amount_students_ > old_amount_students;//a blank roster enrols nobody and is not journaled
+  if(enrolled && startJournalRecord(lecture, "enrol"))
+  {
+    for(int student_index = old_amount_students; student_index < lecture->amount_students_; student_index++)
+    {
+      journalStudent(lecture, NULL, studentsName(lecture->students_ + student_index));
+    }
+    endJournalRecord(lecture);
+  }
+  if(!long_names)//all names were copied into the students
+  {
+    removeFirstNameBlock(lecture);
+  }
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function marks grades of all students and average grade as outdated. Grades themselves are left as
+/// they are, print and export ignore them until they are calculated again, so the change costs O(1). If the grades
+/// were valid, every grade of the snapshot changes to 0, so it cannot be patched any more.
+/// @param lecture lecture
+void invalidateGrades(Lecture* lecture)
+{
+  if(lecture->grades_state_ == LOADED_GRADES || lecture->grades_state_ == CALCULATED_GRADES)
+  {
+    forgetSnapshot(lecture);
+  }
+  if(lecture->grades_state_ != NO_GRADES)
+  {
+    lecture->grades_state_ = OUTDATED_GRADES;
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function removes students from the lecture and keeps the order of the others. The students are removed
+/// from the name index, then the array is compacted once: every run of students between two removed ones is moved to
+/// the left with one memmove per column, and at last the name index is renumbered once, so removing many students
+/// does not cost one shift of the array per student.
+/// @param lecture lecture
+/// @param removed_indices sorted indices of the students, without duplicates
+/// @param amount_removed amount of students to remove
+void compactStudents(Lecture* lecture, int* removed_indices, int amount_removed)
+{
+  for(int removed = 0; removed < amount_removed; removed++)
+  {
+    removeFromNameIndex(lecture, removed_indices[removed]);
+    lecture->points_histogram_[lecture->points_[removed_indices[removed]]]--;
+  }
+  int target = removed_indices[0];
+  for(int removed = 0; removed < amount_removed; removed++)
+  {
+    int run_start = removed_indices[removed] + 1;
+    int run_end = removed + 1 < amount_removed ? removed_indices[removed + 1] : lecture->amount_students_;
+    int run_length = run_end - run_start;
+    memmove(lecture->students_ + target, lecture->students_ + run_start, run_length * sizeof(Student));
+    memmove(lecture->points_ + target, lecture->points_ + run_start, run_length * sizeof(uint8_t));
+    memmove(lecture->grades_ + target, lecture->grades_ + run_start, run_length * sizeof(uint8_t));
+    target += run_length;
+  }
+  lecture->amount_students_ = target;
+  renumberNameIndex(lecture, removed_indices, amount_removed);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function removes a student in O(1) by moving the last student into its place, so the order of the
+/// students changes. Only the slot of the moved student in the name index is updated.
+/// @param lecture lecture
+/// @param student_index index of the removed student
+void swapRemoveStudent(Lecture* lecture, int student_index)
+{
+  removeFromNameIndex(lecture, student_index);
+  lecture->points_histogram_[lecture->points_[student_index]]--;
+  int last_student = lecture->amount_students_ - 1;
+  if(student_index != last_student)
+  {
+    *(lecture->students_ + student_index) = *(lecture->students_ + last_student);
+    lecture->points_[student_index] = lecture->points_[last_student];
+    lecture->grades_[student_index] = lecture->grades_[last_student];
+    lecture->name_index_[findNameSlot(lecture, studentsName(lecture->students_ + student_index))] = student_index;
+  }
+  lecture->amount_students_--;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents a command remove. It finds all target students first, so that either all of them
+/// or none of them are removed, marks grades and average grade as outdated, removes the students and shrinks array
+/// of the students if most of it is unused. With remove --swap every student is replaced by the last one, otherwise
+/// the order of the students is kept and the array is compacted once for all of them.
+/// @param lecture lecture
+/// @param names names of the target students, there is at least one
+/// @param swap true for remove --swap
+/// @return 0 on success, STUDENT_NOT_FOUND if a student does not exist or is named twice, MEMORY_ERROR if allocation
+/// failed
+int removeStudents(Lecture* lecture, Arguments names, bool swap)
+{
+  int amount_names = names.amount_;
+  int* indices = malloc(amount_names * sizeof(int));
+  if(indices == NULL)
+  {
+    return MEMORY_ERROR;
+  }
+  Arguments remaining_names = names;
+  for(int name_index = 0; name_index < amount_names; name_index++)
+  {
+    indices[name_index] = studentNameInLecture(lecture, nextArgument(&remaining_names));
+    if(indices[name_index] == NO_STUDENT)
+    {
+      printf("Error: Student not found!\n");
+      free(indices);
+      return STUDENT_NOT_FOUND;
+    }
+  }
+  qsort(indices, amount_names, sizeof(int), compareIndices);
+  for(int name_index = 1; name_index < amount_names; name_index++)
+  {
+    if(indices[name_index] == indices[name_index - 1])//the second one would not be found any more
+    {
+      printf("Error: Student not found!\n");
+      free(indices);
+      return STUDENT_NOT_FOUND;
+    }
+  }
+  if(startJournalRecord(lecture, swap ? "remove --swap" : "remove"))
+  {
+    for(char* name = nextArgument(&names); name != NULL; name = nextArgument(&names))
+    {
+      journalStudent(lecture, NULL, name);
+    }
+    endJournalRecord(lecture);
+  }
+  invalidateGrades(lecture);
+  invalidateSortedOrders(lecture, true);
+  forgetSnapshot(lecture);
+  if(swap)
+  {
+    for(int name_index = amount_names - 1; name_index >= 0; name_index--)
+    {//from the back, so that the last student is never one that still has to be removed
+      swapRemoveStudent(lecture, indices[name_index]);
+    }
+  }
+  else
+  {
+    compactStudents(lecture, indices, amount_names);
+  }
+  shrinkStudentsIfSparse(lecture);
+  free(indices);
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function receives an array of characters, that represent points. This array can also have '-' to
+/// substract points. Then function checks whether we need to add or substract them, checks whether they are valid 
+/// characters and converts them to an integer.
+/// @param points array that represent points
+/// @param add logical variable to add/substract
+/// @return number points on success, WRONG_ARGUMENT on failure
+int extractAndCheckPoints(char* points, bool* add)
+{
+  int points_number = 0;
+  int points_length = strlen(points);
+  if(*points == '-')
+  {
+    *add = false;//substract points
+    if(points_length > 4)
+    {
+      return WRONG_ARGUMENT;
+    }
+    for(int points_index = 1 ; points_index < points_length; points_index++)
+    {
+      if(isdigit(*(points + points_index)) == 0)
+      {
+        return WRONG_ARGUMENT;
+      }
+    }
+    points_number = atoi(points + 1);
+    if(points_number > 100 || points_number < 0)
+    {
+      return WRONG_ARGUMENT;
+    }
+    return points_number;
+  }
+  *add = true;//add points
+  if(points_length > 3)
+  {
+    return WRONG_ARGUMENT;
+  }
+  for(int points_index = 0 ; points_index < points_length; points_index++)
+  {
+    if(isdigit(*(points + points_index)) == 0)
+    {
+      return WRONG_ARGUMENT;
+    }
+  }
+  points_number = atoi(points);
+  if(points_number > 100 || points_number < 0)
+  {
+    return WRONG_ARGUMENT;
+  }
+  return points_number;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks whether the operation with points will cause points of a target student to exceed the
+/// limit.
+/// @param lecture lecture
+/// @param student_index target student
+/// @param points number of points
+/// @param add logical variable to add/substract
+/// @return number points on success, POINTS_LIMIT on failure
+int pointsLimit(Lecture* lecture, int student_index, int points, bool add)
+{
+  if(lecture->points_[student_index] + points > 100 && add)
+  {
+    return POINTS_LIMIT;
+  }
+  if(lecture->points_[student_index] - points < 0 && !add)
+  {
+    return POINTS_LIMIT;
+  }
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function adds/substracts certain amount of points to/from a target student and moves the student to
+/// the new bucket of the points histogram. The cached order by points is dropped and the student is marked as changed
+/// for export --incremental.
+/// @param lecture lecture
+/// @param points number of points to add/substract
+/// @param student_index target student
+/// @param add logical variable to add/substract
+void givePointsToStudent(Lecture* lecture, int points, int student_index, bool add)
+{
+  lecture->points_histogram_[lecture->points_[student_index]]--;
+  if(add)
+  {
+    lecture->points_[student_index] += points;
+  }
+  if(!add)
+  {
+    lecture->points_[student_index] -= points;
+  }
+  lecture->points_histogram_[lecture->points_[student_index]]++;
+  invalidateSortedOrders(lecture, false);
+  if(lecture->changed_points_ != NULL)
+  {
+    lecture->changed_points_[student_index / 64] |= (uint64_t)1 << (student_index % 64);
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This fucntion represents a command give. It extracts points from an argument, finds a target student, 
+/// checks the points limit, marks grades and average as outdated and gives/substracts points to/from the target
+/// student.
+/// @param lecture lecture
+/// @param points argument which is responsible for points
+/// @param name name of the target student
+/// @return 0 on success, WRONG_ARGUMENT on failure
+int give(Lecture* lecture, char* points, char* name)
+{
+  bool add =  true;
+  int points_number = extractAndCheckPoints(points, &add);
+  if(points_number == WRONG_ARGUMENT)
+  {
+    printf("Error: Invalid command usage!\n");
+    return WRONG_ARGUMENT;
+  }
+  int student_index = studentNameInLecture(lecture, name);
+  if(student_index == NO_STUDENT)
+  {
+    printf("Error: Student not found!\n");
+    return WRONG_ARGUMENT;
+  }
+  if(pointsLimit(lecture, student_index, points_number, add) == POINTS_LIMIT)
+  {
+    printf("Error: Points limit exceeded!\n");
+    return WRONG_ARGUMENT;
+  }
+  invalidateGrades(lecture);
+  givePointsToStudent(lecture, points_number, student_index, add);
+  if(startJournalRecord(lecture, "give"))
+  {
+    int given_points = add ? points_number : -points_number;
+    journalStudent(lecture, &given_points, name);
+    endJournalRecord(lecture);
+  }
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function prints why a row of a file with points was rejected.
+/// @param error value returned by giveFromRow
+/// @param row number of the row, starting with 1
+/// @param path path to the file
+void printGiveRowError(int error, int row, char* path)
+{
+  if(error == STUDENT_NOT_FOUND)
+  {
+    printf("Error: Student in line %d of %s not found!\n", row, path);
+    return;
+  }
+  if(error == POINTS_LIMIT)
+  {
+    printf("Error: Points limit exceeded in line %d of %s!\n", row, path);
     return;
   }
-  freeStudents(lecture);
-  free(lecture->name_);
-  lecture->name_ = NULL;
-  free(lecture);
-  lecture = NULL;
+  printf("Error: Invalid row %d in %s!\n", row, path);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks and applies one row of a file with points (name,+/-points) the same way as a command
+/// give does it, except that grades are not marked as outdated here. The applied change is written to the undo log.
+/// @param lecture lecture
+/// @param row row without '\n', terminated with '\0'
+/// @param undo_index index of the student is written here
+/// @param undo_points signed amount of points that was given is written here
+/// @return 0 on success or if the row is empty, other values describe the problem of the row
+int giveFromRow(Lecture* lecture, char* row, int* undo_index, int* undo_points)
+{
+  *undo_index = NO_STUDENT;
+  if(*row == '\0')
+  {
+    return 0;
+  }
+  char* comma = strchr(row, ',');
+  if(comma == NULL)
+  {
+    return MALFORMED_ROW;
+  }
+  *comma = '\0';
+  char* points = comma + 1;
+  if(*points == '+')
+  {
+    points++;
+  }
+  bool add = true;
+  int points_number = *points == '\0' ? WRONG_ARGUMENT : extractAndCheckPoints(points, &add);
+  if(points_number == WRONG_ARGUMENT)
+  {
+    return MALFORMED_ROW;
+  }
+  int student_index = studentNameInLecture(lecture, row);
+  if(student_index == NO_STUDENT)
+  {
+    return STUDENT_NOT_FOUND;
+  }
+  if(pointsLimit(lecture, student_index, points_number, add) == POINTS_LIMIT)
+  {
+    return POINTS_LIMIT;
+  }
+  givePointsToStudent(lecture, points_number, student_index, add);
+  *undo_index = student_index;
+  *undo_points = add ? points_number : -points_number;
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents a command give --from. Every row of the file (name,+/-points) is checked against
+/// the current points of the student, so several rows for one student add up, and is applied right away while the
+/// change is written to an undo log. If a row is wrong, all changes are undone in the reverse order and the row is
+/// reported, so either all rows are applied or none. Grades and average are marked as outdated once at the end, and the
+/// change is journaled, only if a row gave points to a student.
+/// @param lecture lecture
+/// @param path path to the file with points
+/// @return 0 on success, FILE_ERROR if the file could not be read, MEMORY_ERROR if allocation failed, WRONG_ARGUMENT
+/// if a row is wrong
+int giveFromFile(Lecture* lecture, char* path)
+{
+  long size = 0;
+  FILE* file = openWithSize(path, &size);
+  if(file == NULL)
+  {
+    return FILE_ERROR;
+  }
+  char* rows = malloc(size + 1);//+1 so that the last row always ends with '\n'
+  if(rows == NULL)
+  {
+    fclose(file);
+    return MEMORY_ERROR;
+  }
+  size = fread(rows, 1, size, file);
+  fclose(file);
+  rows[size] = '\n';
+  int amount_rows = 0;
+  for(char* newline = rows; (newline = memchr(newline, '\n', rows + size + 1 - newline)) != NULL; newline++)
+  {
+    amount_rows++;
+  }
+  int* undo_indices = malloc(amount_rows * sizeof(int));
+  int* undo_points = malloc(amount_rows * sizeof(int));
+  if(undo_indices == NULL || undo_points == NULL)
+  {
+    free(undo_indices);
+    free(undo_points);
+    free(rows);
+    return MEMORY_ERROR;
+  }
+  int result = 0;
+  int applied_rows = 0;
+  char* row = rows;
+  for(; applied_rows < amount_rows; applied_rows++)
+  {
+    char* newline = memchr(row, '\n', rows + size + 1 - row);
+    *newline = '\0';
+    result = giveFromRow(lecture, row, undo_indices + applied_rows, undo_points + applied_rows);
+    if(result != 0)
+    {
+      break;
+    }
+    row = newline + 1;
+  }
+  if(result != 0)
+  {
+    for(int row_index = applied_rows - 1; row_index >= 0; row_index--)
+    {
+      if(undo_indices[row_index] != NO_STUDENT)
+      {
+        givePointsToStudent(lecture, abs(undo_points[row_index]), undo_indices[row_index], undo_points[row_index] < 0);
+      }
+    }
+    printGiveRowError(result, applied_rows + 1, path);
+  }
+  bool changed = false;//empty and blank rows change nothing
+  for(int row_index = 0; row_index < applied_rows && result == 0 && !changed; row_index++)
+  {
+    changed = undo_indices[row_index] != NO_STUDENT;
+  }
+  if(changed)
+  {
+    invalidateGrades(lecture);
+    if(startJournalRecord(lecture, "give"))
+    {
+      for(int row_index = 0; row_index < applied_rows; row_index++)
+      {
+        if(undo_indices[row_index] != NO_STUDENT)
+        {
+          journalStudent(lecture, undo_points + row_index, studentsName(lecture->students_ + undo_indices[row_index]));
+        }
+      }
+      endJournalRecord(lecture);
+    }
+  }
+  free(undo_indices);
+  free(undo_points);
+  free(rows);
+  return result == 0 ? 0 : WRONG_ARGUMENT;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function finds the highest amount of points in the lecture in the points histogram, without going
+/// through the students.
+/// @param lecture lecture
+/// @return highest amount of points
+int findHighestPoints(Lecture* lecture)
+{
+  for(int points = MAX_POINTS; points > 0; points--)
+  {
+    if(lecture->points_histogram_[points] != 0)
+    {
+      return points;
+    }
+  }
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function finds the lowest amount of points for grades 4, 3, 2 and 1. A student gets grade 1 with at
+/// least 87 percent of the highest points, that is points * 100 >= 87 * highest_points, so the limit is the rounded up
+/// 87 * highest_points / 100. The same holds for 75 (grade 2), 62 (grade 3) and 51 (grade 4) percent. If nobody has
+/// any points all limits are 0 and everybody gets 1.
+/// @param highest_points highest amount of points in the lecture
+/// @param thresholds lowest amount of points for grades 4, 3, 2 and 1 is written here
+void fillGradeThresholds(int highest_points, int thresholds[GRADE_THRESHOLDS])
+{
+  int percentages[GRADE_THRESHOLDS] = {51, 62, 75, 87};
+  for(int threshold = 0; threshold < GRADE_THRESHOLDS; threshold++)
+  {
+    thresholds[threshold] = (percentages[threshold] * highest_points + 99) / 100;
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function grades students one by one. Every reached threshold improves the grade by one, so there are no
+/// branches. It grades the students left over by the vector kernels as well.
+/// @param points column with points
+/// @param grades column with grades, is written
+/// @param amount_students amount of students
+/// @param thresholds lowest amount of points for grades 4, 3, 2 and 1
+void gradeStudentsScalar(uint8_t* points, uint8_t* grades, int amount_students, int thresholds[GRADE_THRESHOLDS])
+{
+  for(int student_index = 0; student_index < amount_students; student_index++)
+  {
+    int grade = 5;
+    for(int threshold = 0; threshold < GRADE_THRESHOLDS; threshold++)
+    {
+      grade -= points[student_index] >= thresholds[threshold];
+    }
+    grades[student_index] = grade;
+  }
+}
+
+#ifdef GRADING_KERNELS_X86
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function grades students like gradeStudentsScalar, 16 at once with SSE2, which every x86-64 processor
+/// has. A comparison gives -1 for every reached threshold, which is added to 5. Points are at most 100, so they can be
+/// compared as signed bytes.
+/// @param points column with points
+/// @param grades column with grades, is written
+/// @param amount_students amount of students
+/// @param thresholds lowest amount of points for grades 4, 3, 2 and 1
+void gradeStudentsSse2(uint8_t* points, uint8_t* grades, int amount_students, int thresholds[GRADE_THRESHOLDS])
+{
+  __m128i limits[GRADE_THRESHOLDS];//thresholds - 1, because there is only a greater than comparison
+  for(int threshold = 0; threshold < GRADE_THRESHOLDS; threshold++)
+  {
+    limits[threshold] = _mm_set1_epi8(thresholds[threshold] - 1);
+  }
+  int student_index = 0;
+  for(; student_index + 16 <= amount_students; student_index += 16)
+  {
+    __m128i vector_points = _mm_loadu_si128((__m128i*)(points + student_index));
+    __m128i vector_grades = _mm_set1_epi8(5);
+    for(int threshold = 0; threshold < GRADE_THRESHOLDS; threshold++)
+    {
+      vector_grades = _mm_add_epi8(vector_grades, _mm_cmpgt_epi8(vector_points, limits[threshold]));
+    }
+    _mm_storeu_si128((__m128i*)(grades + student_index), vector_grades);
+  }
+  gradeStudentsScalar(points + student_index, grades + student_index, amount_students - student_index, thresholds);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function grades students like gradeStudentsSse2, 32 at once with AVX2.
+/// @param points column with points
+/// @param grades column with grades, is written
+/// @param amount_students amount of students
+/// @param thresholds lowest amount of points for grades 4, 3, 2 and 1
+__attribute__((target("avx2")))
+void gradeStudentsAvx2(uint8_t* points, uint8_t* grades, int amount_students, int thresholds[GRADE_THRESHOLDS])
+{
+  __m256i limits[GRADE_THRESHOLDS];
+  for(int threshold = 0; threshold < GRADE_THRESHOLDS; threshold++)
+  {
+    limits[threshold] = _mm256_set1_epi8(thresholds[threshold] - 1);
+  }
+  int student_index = 0;
+  for(; student_index + 32 <= amount_students; student_index += 32)
+  {
+    __m256i vector_points = _mm256_loadu_si256((__m256i*)(points + student_index));
+    __m256i vector_grades = _mm256_set1_epi8(5);
+    for(int threshold = 0; threshold < GRADE_THRESHOLDS; threshold++)
+    {
+      vector_grades = _mm256_add_epi8(vector_grades, _mm256_cmpgt_epi8(vector_points, limits[threshold]));
+    }
+    _mm256_storeu_si256((__m256i*)(grades + student_index), vector_grades);
+  }
+  gradeStudentsScalar(points + student_index, grades + student_index, amount_students - student_index, thresholds);
 }
+#endif
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function reads information from the file, checks it and then assigns it to the lecture. It iterates
-/// through all the rows in the file that represent students, gets information about the name, points and grade, checks
-/// all this information with helper functions and assigns it to the current student.
-/// @param file file, where the data is taken from
+/// @brief This function chooses the fastest grading kernel the processor supports.
+/// @return grading kernel
+GradingKernel chooseGradingKernel(void)
+{
+#ifdef GRADING_KERNELS_X86
+#ifndef NO_AVX2_GRADING//-DNO_AVX2_GRADING to measure the SSE2 kernel on a processor with AVX2
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2"))
+  {
+    return gradeStudentsAvx2;
+  }
+#endif
+  return gradeStudentsSse2;
+#else
+  return gradeStudentsScalar;
+#endif
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function fills the grade of every possible amount of points, it is used by calc --lazy and to count
+/// students with each grade.
 /// @param lecture lecture
-/// @param amount_students amount of students
-/// @param path path to that file, is used to print error message
-/// @return 0 if success, MALFORMED_ROW if the data in file is invalid, MEMORY_ERROR if allocation failed
-int writeFromFileToLecture(FILE* file, Lecture* lecture, int amount_students, char* path)
+/// @param thresholds lowest amount of points for grades 4, 3, 2 and 1
+void fillGradeOfPoints(Lecture* lecture, int thresholds[GRADE_THRESHOLDS])
+{
+  uint8_t all_points[MAX_POINTS + 1];
+  uint8_t grades[MAX_POINTS + 1];
+  for(int points = 0; points <= MAX_POINTS; points++)
+  {
+    all_points[points] = points;
+  }
+  gradeStudentsScalar(all_points, grades, MAX_POINTS + 1, thresholds);
+  memcpy(lecture->grade_of_points_, grades, sizeof(grades));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function calculates average grade in the lecture from the points histogram and the grade of every
+/// amount of points, so it counts students with each grade without going through the students.
+/// @param lecture lecture
+/// @return average grade
+float calculateAverageGrade(Lecture* lecture)
+{
+  long amount_grades[6] = {0};//index is the grade
+  for(int points = 0; points <= MAX_POINTS; points++)
+  {
+    amount_grades[(int)lecture->grade_of_points_[points]] += lecture->points_histogram_[points];
+  }
+  long total = 0;
+  for(int grade = 1; grade <= 5; grade++)
+  {
+    total += grade * amount_grades[grade];
+  }
+  float average_grade = (float)total / lecture->amount_students_;
+  return average_grade;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function returns grade of the student. Grades calculated with calc --lazy are not stored in the
+/// students, they are looked up by points. Students enrolled after calc have grade 0 in both cases, they are always at
+/// the end, because any other change marks the grades as outdated.
+/// @param lecture lecture
+/// @param student_index index of the student
+/// @return grade of the student
+int gradeOfStudent(Lecture* lecture, int student_index)
+{
+  if(lecture->lazy_grades_ && lecture->grades_state_ == CALCULATED_GRADES && student_index < lecture->graded_students_)
+  {
+    return lecture->grade_of_points_[lecture->points_[student_index]];
+  }
+  return lecture->grades_[student_index];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function assigns a grade to each student according to the highest number of points in the lecture.
+/// The highest number of points and the average grade are taken from the points histogram, the grades are calculated
+/// from the column of points by the fastest grading kernel. With calc --lazy grades are not assigned to the students
+/// at all, they are looked up when they are printed or exported.
+/// @param lecture lecture
+/// @param lazy true for calc --lazy
+void calc(Lecture* lecture, bool lazy)
+{
+  if(lecture->amount_students_ == 0)
+  {
+    return;
+  }
+  int thresholds[GRADE_THRESHOLDS];
+  fillGradeThresholds(findHighestPoints(lecture), thresholds);
+  fillGradeOfPoints(lecture, thresholds);
+  lecture->lazy_grades_ = lazy;
+  lecture->graded_students_ = lecture->amount_students_;
+  if(!lazy)
+  {
+    chooseGradingKernel()(lecture->points_, lecture->grades_, lecture->amount_students_, thresholds);
+  }
+  lecture->average_grade_ = calculateAverageGrade(lecture);
+  lecture->grades_state_ = CALCULATED_GRADES;
+  forgetSnapshot(lecture);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function compares two students by their names, it is used by qsort and by the heap of fillNamesOrder.
+/// @param first pointer to the first student
+/// @param second pointer to the second student
+/// @return negative, 0 or positive value like strcmp
+int compareStudentsByName(const void* first, const void* second)
+{
+  return strcmp(studentsName(*(Student* const*)first), studentsName(*(Student* const*)second));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function moves a student down the max-heap of fillNamesOrder until both of its children have
+/// alphabetically earlier names.
+/// @param heap students in the heap, the one with the alphabetically last name is at the top
+/// @param size amount of students in the heap
+/// @param position position of the student to move down
+void siftDownByName(Student** heap, int size, int position)
 {
-  int current_student = 0;
-  while(current_student < amount_students)
+  while(true)
   {
-    int student_name_length = 0;
-    int current_character = 0;
-    while(current_character != ',')
+    int largest = position;
+    for(int child = 2 * position + 1; child <= 2 * position + 2 && child < size; child++)
     {
-      current_character = fgetc(file);
-      student_name_length++;//maybe change that
-      if(current_character == EOF)
+      if(compareStudentsByName(heap + child, heap + largest) > 0)
       {
-        freeLecture(lecture);
-        printf("Error: Invalid file: %s!\n", path);
-        return MALFORMED_ROW;
-      }//to avoid infinite loop if the file will end unexpectedly
-    }//we have + 1 character for '\0' because it increases student_name_length when character is already ','
-    //its one character longer but we need exactly that because we need one character for null terminator
-    char* student_name = calloc(student_name_length, sizeof(char));
-    if(student_name == NULL)
-    {
-      freeLecture(lecture);
-      return MEMORY_ERROR;
+        largest = child;
+      }
     }
-    fseek(file, -student_name_length, SEEK_CUR);
-    fgets(student_name, student_name_length, file);
-    if(checkStudentsName(student_name) == INCORRECT_STUDENTS_NAME)
+    if(largest == position)
     {
-      freeLecture(lecture);
-      free(student_name);
-      return MALFORMED_ROW;
+      return;
     }
-    (lecture->students_ + current_student)->name_ = student_name;
-    fseek(file, 1, SEEK_CUR);//skipping ','
-    char points_array[4] = {0};//3 for numbers one for ','
-    fgets(points_array, 4, file);
-    int points = checkAndCalculatePoints(points_array, path);
-    if(points == MALFORMED_ROW)
+    Student* student = heap[position];
+    heap[position] = heap[largest];
+    heap[largest] = student;
+    position = largest;
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function writes the indices of the students with the most points into the order, from the highest
+/// points down, students with equal points in the order of enrolment. It is a counting sort over the points
+/// histogram: the histogram tells the lowest points that still get into the order and the position where each amount
+/// of points starts, then one pass over the points column puts every student to its place. No students are compared
+/// and the pass stops as soon as the order is full.
+/// @param lecture lecture
+/// @param order array for the indices
+/// @param length amount of students to write, at most the amount of students in the lecture
+void fillPointsOrder(Lecture* lecture, int* order, int length)
+{
+  int next_position[MAX_POINTS + 1];
+  int lowest_points = MAX_POINTS;
+  for(int points = MAX_POINTS, position = 0; points >= 0 && position < length; points--)
+  {
+    next_position[points] = position;
+    position += lecture->points_histogram_[points];
+    lowest_points = points;
+  }
+  int placed = 0;
+  for(int student_index = 0; placed < length; student_index++)
+  {
+    int points = lecture->points_[student_index];
+    if(points >= lowest_points && next_position[points] < length)//only the first ones with the lowest points fit
     {
-      free(student_name);
-      freeLecture(lecture);
-      return MALFORMED_ROW;
+      order[next_position[points]++] = student_index;
+      placed++;
     }
-    (lecture->students_ + current_student)->points_ = points;
-    if(points < 10)
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function writes the indices of the students with alphabetically first names into the order. For the
+/// whole lecture all students are sorted, for fewer students a max-heap keeps the first names seen so far, which
+/// costs O(n log length), and only these students are sorted at the end.
+/// @param lecture lecture
+/// @param order array for the indices
+/// @param length amount of students to write, at least 1 and at most the amount of students in the lecture
+/// @return 0 on success, MEMORY_ERROR if allocation failed
+int fillNamesOrder(Lecture* lecture, int* order, int length)
+{
+  Student** selected = malloc(length * sizeof(Student*));
+  if(selected == NULL)
+  {
+    return MEMORY_ERROR;
+  }
+  for(int student_index = 0; student_index < length; student_index++)
+  {
+    selected[student_index] = lecture->students_ + student_index;
+  }
+  if(length < lecture->amount_students_)
+  {
+    for(int position = length / 2 - 1; position >= 0; position--)
     {
-      fseek(file, -1, SEEK_CUR);
+      siftDownByName(selected, length, position);
     }
-    else if(points == 100)
-    {
-      fseek(file, 1, SEEK_CUR);
-    }//now we are at the character after the ','
-    char grade_array[3] = {0};
-    fgets(grade_array, 3, file);
-    int grade = checkAndCalculateGrade(grade_array, path);
-    if(grade == MALFORMED_ROW)
+    for(int student_index = length; student_index < lecture->amount_students_; student_index++)
     {
-      free(student_name);
-      freeLecture(lecture);
-      return MALFORMED_ROW;
+      Student* student = lecture->students_ + student_index;
+      if(compareStudentsByName(&student, selected) < 0)//earlier than the last selected name
+      {
+        selected[0] = student;
+        siftDownByName(selected, length, 0);
+      }
     }
-    (lecture->students_ + current_student)->grade_ = grade;
-    current_student++;
-    lecture->amount_students_ = current_student;
   }
-  lecture->amount_students_ = amount_students;
+  qsort(selected, length, sizeof(Student*), compareStudentsByName);
+  for(int position = 0; position < length; position++)
+  {
+    order[position] = selected[position] - lecture->students_;
+  }
+  free(selected);
   return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function iterates through the students and checks whether there already is a student with a name that
-/// is the same as the name of the target student. Remark: it starts with the student that is after the target one.
+/// @brief This function returns the first students of the lecture sorted by points or by names. The order is cached
+/// in the lecture until students are enrolled, removed or get points, so repeated print --sort commands do not sort
+/// again. Up to half of the lecture only the needed students are selected and cached, for more the whole lecture is
+/// sorted, which costs about the same and serves every later limit as well.
 /// @param lecture lecture
-/// @param current_student target student
-/// @return 0 if the name is unique, NOT_UNIQUE_NAME if the name is not unique
-int sameNamesExist(Lecture* lecture, int current_student)
+/// @param by_name logical variable, sort by names instead of points
+/// @param length amount of students that are needed, at least 1 and at most the amount of students in the lecture
+/// @return indices of the students, they belong to the lecture, NULL if allocation failed
+int* sortedOrder(Lecture* lecture, bool by_name, int length)
+{
+  SortedOrder* order = by_name ? &lecture->names_order_ : &lecture->points_order_;
+  if(order->indices_ != NULL && order->length_ >= length)
+  {
+    return order->indices_;
+  }
+  free(order->indices_);
+  order->indices_ = NULL;
+  order->length_ = 0;
+  if(length > lecture->amount_students_ / 2)
+  {
+    length = lecture->amount_students_;
+  }
+  int* indices = malloc(length * sizeof(int));
+  if(indices == NULL)
+  {
+    return NULL;
+  }
+  if(!by_name)
+  {
+    fillPointsOrder(lecture, indices, length);
+  }
+  else if(fillNamesOrder(lecture, indices, length) == MEMORY_ERROR)
+  {
+    free(indices);
+    return NULL;
+  }
+  order->indices_ = indices;
+  order->length_ = length;
+  return indices;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function writes everything that was collected in the output buffer to its file with one fwrite and
+/// adds it to the checksum, if there is one.
+/// @param output output buffer
+void flushOutput(OutputBuffer* output)
+{
+  if(output->checksum_ != NULL)
+  {
+    *output->checksum_ = updateChecksum(*output->checksum_, (unsigned char*)output->data_, output->used_);
+  }
+  if(!output->failed_ && fwrite(output->data_, 1, output->used_, output->file_) != (size_t)output->used_)
+  {
+    output->failed_ = true;
+  }
+  output->used_ = 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function adds characters to the output buffer. If they do not fit the buffer is flushed first, text that
+/// is longer than the whole buffer is written right away.
+/// @param output output buffer
+/// @param text characters to add, not terminated
+/// @param length amount of the characters
+void appendToOutput(OutputBuffer* output, char* text, size_t length)
 {
-  for(int student_index = current_student + 1; student_index < lecture->amount_students_; student_index++)
+  if(output->used_ + length > (size_t)output->size_)
+  {
+    flushOutput(output);
+  }
+  if(length > (size_t)output->size_)
   {
-    if(strcmp(lecture->students_[current_student].name_, lecture->students_[student_index].name_) == 0)
+    if(output->checksum_ != NULL)
     {
-      return NOT_UNIQUE_NAME;
+      *output->checksum_ = updateChecksum(*output->checksum_, (unsigned char*)text, length);
     }
+    output->failed_ = output->failed_ || fwrite(text, 1, length, output->file_) != length;
+    return;
   }
-  return 0;
+  memcpy(output->data_ + output->used_, text, length);
+  output->used_ += length;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function makes sure that there is space for the given amount of characters in the output buffer and
+/// flushes it if there is not. The caller writes the characters to the returned address and adds their amount to
+/// used_ of the buffer, so short parts of a row do not need one call each.
+/// @param output output buffer
+/// @param length amount of characters, at most the size of the buffer
+/// @return address of the free space
+char* reserveOutput(OutputBuffer* output, int length)
+{
+  if(output->used_ + length > output->size_)
+  {
+    flushOutput(output);
+  }
+  return output->data_ + output->used_;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function checks if the lecture contains students with the same names.
+/// @brief This function writes a number of points or a grade as text without printf, it has at most 3 digits.
+/// @param text the digits are written here, they are not terminated
+/// @param number number from 0 to 999
+/// @return amount of digits
+int formatNumber(char* text, int number)
+{
+  int length = 0;
+  if(number >= 100)
+  {
+    text[length++] = '0' + number / 100;
+  }
+  if(number >= 10)
+  {
+    text[length++] = '0' + number / 10 % 10;
+  }
+  text[length++] = '0' + number % 10;
+  return length;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function adds the name of a student to the output buffer.
+/// @param output output buffer
+/// @param student student
+void appendNameToOutput(OutputBuffer* output, Student* student)
+{
+  char* name = studentsName(student);
+  appendToOutput(output, name, student->length_ != LONG_NAME ? student->length_ : strlen(name));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function prints the students at the given positions with their points and, if they are valid, their
+/// grades. All rows are formatted by hand into one buffer, which goes to stdout with one fwrite whenever it is full,
+/// so there are no printf calls per student.
+/// @param lecture lecture
+/// @param order indices of the students in the order to print, NULL to print them in the order of enrolment
+/// @param first position of the first student to print
+/// @param end position after the last student to print
+/// @param with_grades logical variable, print the grades as well
+void printStudents(Lecture* lecture, int* order, int first, int end, bool with_grades)
+{
+  char buffer[OUTPUT_BUFFER_SIZE];
+  OutputBuffer output = {stdout, buffer, OUTPUT_BUFFER_SIZE, 0, false, NULL};
+  appendToOutput(&output, "+===========================+\n", 30);
+  for(int position = first; position < end; position++)
+  {
+    int student_index = order == NULL ? position : order[position];
+    appendToOutput(&output, "Name: ", 6);
+    appendNameToOutput(&output, lecture->students_ + student_index);
+    char* row = reserveOutput(&output, PRINT_ROW_END);
+    memcpy(row, "\nPoints: ", 9);
+    int length = 9 + formatNumber(row + 9, lecture->points_[student_index]);
+    if(with_grades)
+    {
+      memcpy(row + length, "\nGrade: ", 8);
+      length += 8 + formatNumber(row + length + 8, gradeOfStudent(lecture, student_index));
+    }
+    memcpy(row + length, "\n+---------------------------+\n", 31);
+    output.used_ += length + 31;
+  }
+  flushOutput(&output);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function is responsible for printing lecture info. Depending on the state of the grades it prints grades
+/// and average, just grades (loaded from the file) or it does not print grades and average at all. Outdated grades are
+/// not printed, the lecture is marked as outdated instead.
+/// @param lecture lecture
+/// @param order indices of the students in the order to print, NULL to print them in the order of enrolment
+/// @param first position of the first student to print
+/// @param end position after the last student to print
+void print(Lecture* lecture, int* order, int first, int end)
+{
+  printf("+===========================+\n");
+  printf("Lecture: %s\n", lecture->name_);
+  printf("Number of students: %d\n", lecture->amount_students_);
+  switch(lecture->grades_state_)
+  {
+    case CALCULATED_GRADES:
+      printf("Average Grade: %.2f\n", lecture->average_grade_);
+      printStudents(lecture, order, first, end, true);
+      break;
+    case LOADED_GRADES:
+      printStudents(lecture, order, first, end, true);
+      break;
+    case OUTDATED_GRADES:
+      printf("Grades: outdated, use calc\n");
+      printStudents(lecture, order, first, end, false);
+      break;
+    default:
+      printStudents(lecture, order, first, end, false);
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents a command print with its options. print --sort points|name prints the students
+/// sorted by points or by names, --limit <K> prints only the first K students and --range <start>:<count> prints count
+/// students from the position start, so a big lecture can be read page by page. Both can also be used without --sort.
 /// @param lecture lecture
-/// @return 0 if the names are unique, NOT_UNIQUE_NAME if not
-int checkSameStudentNames(Lecture* lecture)
+/// @param arguments arguments of print, checked by checkPrintOptions
+/// @return 0 on success, WRONG_ARGUMENT if the argument of --limit or --range is invalid, MEMORY_ERROR if allocation
+/// failed
+int printCommand(Lecture* lecture, Arguments arguments)
 {
-  for(int current_student = 0; current_student < lecture->amount_students_; current_student++)
+  char* option = nextArgument(&arguments);
+  char* order_name = NULL;
+  bool sort = option != NULL && strcmp(option, "--sort") == 0;
+  if(sort)
+  {
+    order_name = nextArgument(&arguments);
+    option = nextArgument(&arguments);
+  }
+  int first = 0;
+  int count = lecture->amount_students_;
+  if(option != NULL)
+  {
+    char* argument = nextArgument(&arguments);
+    int result = strcmp(option, "--limit") == 0 ? parseLimit(argument, &count) : parseRange(argument, &first, &count);
+    if(result == WRONG_ARGUMENT)
+    {
+      printf("Error: Invalid command usage!\n");
+      return WRONG_ARGUMENT;
+    }
+  }
+  first = first < lecture->amount_students_ ? first : lecture->amount_students_;
+  int end = count < lecture->amount_students_ - first ? first + count : lecture->amount_students_;
+  int* order = NULL;
+  if(sort && end > 0)
   {
-    if(sameNamesExist(lecture, current_student) == NOT_UNIQUE_NAME)
+    order = sortedOrder(lecture, strcmp(order_name, "name") == 0, end);
+    if(order == NULL)
     {
-      return NOT_UNIQUE_NAME;
+      return MEMORY_ERROR;
     }
   }
+  print(lecture, order, first, end);
   return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function represents command load. It opens a file, writes data from file to the lecture, closes file.
-/// @param token_2 path to the file, gets modified at some point
+/// @brief This function writes data from the lecture to the csv report. Rows of all students are formatted by hand
+/// into one buffer on the stack, which is written to the file whenever it is full, so there is no printf and no
+/// allocation per student and the file is unbuffered. The rows go to a temporary file first, which is synced to the
+/// disk and renamed to the report only when everything was written, so the report is either the old one or the
+/// complete new one. Outdated grades are written as 0, like grades that do not exist.
 /// @param lecture lecture
-/// @param path copy of the second token, we need it to print error messages
-/// @return 0 on success, FILE_ERROR if file has not opened, MEMORY_ERROR if allocation failed, 
-/// INCORRECT_LECTURE_NAME if the name is invalid, MALFORMED_ROW if data in the file is invalid
-int loadLecture(char* token_2, Lecture** lecture, char* path)
+/// @param checksum Adler-32 of the written report, 1 before, the journal is bound to the report with it
+/// @return 0 on success, FILE_ERROR if the file could not be created, WRITE_ERROR if it could not be written
+int writeReport(Lecture* lecture, uint32_t* checksum)
 {
-  FILE* file = fopen(token_2, "r");
+  FILE* file = fopen(lecture->report_temp_path_, "w");
   if(file == NULL)
   {
-    printf("Error: Cannot open file: %s!\n", path);
     return FILE_ERROR;
   }
-  char* lecture_name = getNameForLecture(token_2);
-  int amount_students = calculateAmountOfStudents(file);
-  int result = createLecture(lecture_name, lecture);
-  if(result == MEMORY_ERROR)
+  setvbuf(file, NULL, _IONBF, 0);//the rows are collected in the buffer below
+  char buffer[OUTPUT_BUFFER_SIZE];
+  OutputBuffer output = {file, buffer, OUTPUT_BUFFER_SIZE, 0, false, checksum};
+  bool valid_grades = lecture->grades_state_ == LOADED_GRADES || lecture->grades_state_ == CALCULATED_GRADES;
+  for(int student_index = 0; student_index < lecture->amount_students_ && !output.failed_; student_index++)
   {
-    fclose(file);
-    return MEMORY_ERROR;
+    appendNameToOutput(&output, lecture->students_ + student_index);
+    char* row = reserveOutput(&output, EXPORT_ROW_END);
+    int length = 0;
+    row[length++] = ',';
+    length += formatNumber(row + length, lecture->points_[student_index]);
+    row[length++] = ',';
+    length += formatNumber(row + length, valid_grades ? gradeOfStudent(lecture, student_index) : 0);
+    row[length++] = '\n';
+    output.used_ += length;
   }
-  if(result == INCORRECT_LECTURE_NAME)
+  flushOutput(&output);
+  bool written = !output.failed_ && fsync(fileno(file)) == 0;
+  written = fclose(file) == 0 && written;
+  if(!written || rename(lecture->report_temp_path_, lecture->report_path_) != 0)
   {
-    fclose(file);
-    return INCORRECT_LECTURE_NAME;
+    remove(lecture->report_temp_path_);
+    return WRITE_ERROR;
+  }
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function stops the journal of the lecture after it could not be written, the changes are kept only
+/// in memory until the journal can be started again by export.
+/// @param lecture lecture
+void stopJournal(Lecture* lecture)
+{
+  printf("Warning: Journal of lecture %s could not be written, changes are kept only in memory!\n", lecture->name_);
+  closeJournal(&lecture->journal_);
+  lecture->journal_.failed_ = true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents a command export. It writes the report (see writeReport) and starts a new empty
+/// journal for it, because the report has all changes now.
+/// @param lecture lecture
+/// @return 0 on success, FILE_ERROR if file could not be created or written
+int export(Lecture* lecture)
+{
+  uint32_t checksum = 1;
+  int result = writeReport(lecture, &checksum);
+  if(result != 0)
+  {
+    printf(result == FILE_ERROR ? "Error: Report could not be created!\n" : "Error: Report could not be written!\n");
+    return FILE_ERROR;
   }
-  if(allocateStudents(*lecture, amount_students) == MEMORY_ERROR)
+  if(startJournal(lecture, checksum) != 0)
   {
-    fclose(file);
-    return MEMORY_ERROR;
+    stopJournal(lecture);
   }
-  int writing_result = writeFromFileToLecture(file, *lecture, amount_students, path);
-  if(writing_result == MEMORY_ERROR)
+  if(lecture->grades_state_ == OUTDATED_GRADES)
   {
-    fclose(file);
-    return MEMORY_ERROR;
+    printf("Warning: Grades are outdated, they were exported as 0!\n");
   }
-  if(writing_result == MALFORMED_ROW)
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function writes a snapshot of the lecture, which load reads without parsing: a header, the points
+/// column, the grades column (outdated grades as 0, like export), the offsets of the names and the blob of all names,
+/// each ending with '\0'. Everything goes through one buffer that checksums what it writes, then the header with the
+/// checksum is written again at the beginning. Like export, the snapshot is written to a temporary file that is renamed
+/// only when everything was written.
+/// @param lecture lecture
+/// @param path path of the snapshot
+/// @param temp_path path of the temporary file
+/// @param checksum checksum of the snapshot is written here
+/// @return 0 on success, FILE_ERROR if the file could not be created, WRITE_ERROR if it could not be written
+int writeSnapshot(Lecture* lecture, char* path, char* temp_path, uint32_t* checksum)
+{
+  uint64_t names_size = 0;
+  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
   {
-    fclose(file);
-    return MALFORMED_ROW;
+    Student* student = lecture->students_ + student_index;
+    names_size += (student->length_ != LONG_NAME ? student->length_ : strlen(studentsName(student))) + 1;
+  }
+  FILE* file = names_size <= UINT32_MAX ? fopen(temp_path, "wb") : NULL;//offsets have 32 bits
+  if(file == NULL)
+  {
+    return FILE_ERROR;
+  }
+  setvbuf(file, NULL, _IONBF, 0);//everything is collected in the buffer below
+  SnapshotHeader header = {SNAPSHOT_MAGIC, SNAPSHOT_VERSION, lecture->amount_students_, 1, names_size};
+  bool written = fwrite(&header, sizeof(header), 1, file) == 1;//written again with the checksum at the end
+  char buffer[OUTPUT_BUFFER_SIZE];
+  OutputBuffer output = {file, buffer, OUTPUT_BUFFER_SIZE, 0, false, &header.checksum_};
+  if(lecture->amount_students_ > 0)//points_ of an empty lecture may be NULL
+  {
+    appendToOutput(&output, (char*)lecture->points_, lecture->amount_students_);
+  }
+  bool valid_grades = lecture->grades_state_ == LOADED_GRADES || lecture->grades_state_ == CALCULATED_GRADES;
+  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  {
+    *reserveOutput(&output, 1) = valid_grades ? gradeOfStudent(lecture, student_index) : 0;
+    output.used_++;
+  }
+  uint32_t offset = 0;
+  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  {
+    memcpy(reserveOutput(&output, sizeof(offset)), &offset, sizeof(offset));
+    output.used_ += sizeof(offset);
+    Student* student = lecture->students_ + student_index;
+    offset += (student->length_ != LONG_NAME ? student->length_ : strlen(studentsName(student))) + 1;
+  }
+  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  {
+    appendNameToOutput(&output, lecture->students_ + student_index);
+    appendToOutput(&output, "", 1);//'\0' of the string literal
+  }
+  flushOutput(&output);
+  written = written && !output.failed_ && fseek(file, 0, SEEK_SET) == 0 &&
+            fwrite(&header, sizeof(header), 1, file) == 1;
+  written = fclose(file) == 0 && written;
+  if(!written || rename(temp_path, path) != 0)
+  {
+    remove(temp_path);
+    return WRITE_ERROR;
+  }
+  *checksum = header.checksum_;
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function patches the snapshot of the lecture in place with the points that changed since it was
+/// written, which are the only bytes that can differ: students were not enrolled or removed and grades did not change
+/// (see forgetSnapshot). For every 64 students with a changed bit, their 64 bytes of the points column are read and
+/// written once, and the checksum is corrected byte by byte with patchChecksum instead of reading the whole file.
+/// The header with the new checksum is written last, if the program ends before, load rejects the snapshot.
+/// @param lecture lecture, changed_points_ must not be NULL
+/// @return 0 on success, WRITE_ERROR if the snapshot is not the one that was written or could not be patched
+int patchSnapshot(Lecture* lecture)
+{
+  FILE* file = fopen(lecture->snapshot_path_, "r+b");
+  SnapshotHeader header;
+  if(file == NULL)
+  {
+    return WRITE_ERROR;
+  }
+  setvbuf(file, NULL, _IONBF, 0);//spans of 64 bytes are read and written directly
+  bool written = fread(&header, sizeof(header), 1, file) == 1 && header.magic_ == SNAPSHOT_MAGIC &&
+                 header.checksum_ == lecture->snapshot_checksum_ &&
+                 header.amount_students_ == (uint32_t)lecture->amount_students_;
+  uint64_t body_size = 6 * (uint64_t)header.amount_students_ + header.names_size_;
+  for(int first = 0; first < lecture->amount_students_ && written; first += 64)
+  {
+    if(lecture->changed_points_[first / 64] == 0)
+    {
+      continue;
+    }
+    int length = lecture->amount_students_ - first < 64 ? lecture->amount_students_ - first : 64;
+    uint8_t old_points[64];
+    long position = sizeof(SnapshotHeader) + first;
+    written = fseek(file, position, SEEK_SET) == 0 && fread(old_points, 1, length, file) == (size_t)length &&
+              fseek(file, position, SEEK_SET) == 0 &&
+              fwrite(lecture->points_ + first, 1, length, file) == (size_t)length;
+    for(int index = 0; index < length; index++)
+    {
+      header.checksum_ = patchChecksum(header.checksum_, body_size, first + index, old_points[index],
+                                       lecture->points_[first + index]);
+    }
+    lecture->changed_points_[first / 64] = 0;
+  }
+  written = written && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+  written = fclose(file) == 0 && written;
+  if(!written)
+  {
+    return WRITE_ERROR;
+  }
+  lecture->snapshot_checksum_ = header.checksum_;
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents commands export --binary and export --incremental. The first one writes a snapshot
+/// of the lecture to reports/<name>.bin (see writeSnapshot), the second one only patches the changed points into the
+/// snapshot if that is possible (see patchSnapshot) and writes it whole otherwise. After the snapshot is written
+/// whole, changes of the points are tracked with one bit per student.
+/// @param lecture lecture
+/// @param incremental true for export --incremental
+/// @return 0 on success, FILE_ERROR if file could not be created or written, MEMORY_ERROR if allocation failed
+int exportBinary(Lecture* lecture, bool incremental)
+{
+  int result = incremental && lecture->changed_points_ != NULL ? patchSnapshot(lecture) : WRITE_ERROR;
+  if(result != 0)
+  {
+    forgetSnapshot(lecture);
+    result = writeSnapshot(lecture, lecture->snapshot_path_, lecture->snapshot_temp_path_,
+                           &lecture->snapshot_checksum_);
+    if(result == 0)
+    {
+      lecture->changed_points_ = calloc(lecture->amount_students_ / 64 + 1, sizeof(uint64_t));
+      if(lecture->changed_points_ == NULL)
+      {
+        return MEMORY_ERROR;
+      }
+    }
+  }
+  if(result != 0)
+  {
+    printf(result == FILE_ERROR ? "Error: Report could not be created!\n" : "Error: Report could not be written!\n");
+    return FILE_ERROR;
   }
-  if(checkSameStudentNames(*lecture) == NOT_UNIQUE_NAME)
+  if(lecture->grades_state_ == OUTDATED_GRADES)
   {
-    fclose(file);
-    freeStudents(*lecture);
-    return MALFORMED_ROW;
+    printf("Warning: Grades are outdated, they were exported as 0!\n");
   }
-  fclose(file);
   return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function represents global mode. User is asked to type create/load with arguments. Then lecture is
-/// created or loaded respectively.
+/// @brief This function finishes the records of a command that changed the students of the lecture. The records are
+/// flushed to the journal, so that they survive a crash of the program, and fsynced once every JOURNAL_SYNC_GROUP
+/// records. A journal that has more records than JOURNAL_COMPACTION_RECORDS and than the lecture has students is
+/// compacted into a new report, so replaying it never takes much longer than loading the report.
 /// @param lecture lecture
-/// @param global_mode bool variable that is used to change modes
-/// @return LECTURE_CREATED/FILE_LOADED on success, MEMORY_ERROR if allocation failed, QUIT if user typed "exit",
-/// other values if something is wrong
-int globalMode(Lecture** lecture, bool* global_mode)
+void commitJournal(Lecture* lecture)
 {
-  char* token_1;
-  char* token_2;
-  char* token_3;
-  printf("[] > ");
-  char* input = readUserInput();
-  if(input == NULL)
-  {
-    return MEMORY_ERROR;
-  }
-  int command = checkArgumentsGlobal(&input, &token_1, &token_2, &token_3);
-  if(command == QUIT)
+  Journal* journal = &lecture->journal_;
+  if(journal->file_ == NULL)//not journaled
   {
-    free(input);
-    return QUIT;
-  }
-  if(command == WRONG_ARGUMENT)
-  {
-    free(input);
-    return WRONG_ARGUMENT;
+    return;
   }
-  if(command == CREATE)
+  bool written = true;
+  if(journal->records_ > JOURNAL_COMPACTION_RECORDS && journal->records_ > lecture->amount_students_)
   {
-    int result = createLecture(token_2, lecture);
-    if(result == INCORRECT_LECTURE_NAME)
-    {
-      free(input);
-      return INCORRECT_LECTURE_NAME;//start again
-    }
-    if(result == MEMORY_ERROR)
-    {
-      free(input);
-      return MEMORY_ERROR;//end program
-    }
-    free(input);
-    *global_mode = false;
-    return LECTURE_CREATED;//change mode in the loop
+    uint32_t checksum = 1;
+    written = writeReport(lecture, &checksum) == 0 && startJournal(lecture, checksum) == 0;
   }
-  //if(command == LOAD)//because command atp can only be create or load we can remove this if
-  char* path = malloc(strlen(token_2) + 1);
-  if(path == NULL)
+  else if(journal->unsynced_records_ >= JOURNAL_SYNC_GROUP)
   {
-    free(input);
-    return MEMORY_ERROR;
+    written = syncJournal(journal);
   }
-  strcpy(path, token_2);
-  int load_result = loadLecture(token_2, lecture, path);
-  if(load_result == MEMORY_ERROR)
+  else
   {
-    free(path);
-    free(input);
-    return MEMORY_ERROR;//end program
+    written = fflush(journal->file_) == 0;
   }
-  if(load_result != 0)
+  if(!written)
   {
-    free(path);
-    free(input);
-    return UNSUCCESSFUL_LOAD;//start again
+    stopJournal(lecture);
   }
-  free(path);
-  free(input);
-  *global_mode = false;
-  return FILE_LOADED;//change mode in the loop
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function prints commands for a lecture mode.
-void lectureCommandsPrint(void)
+/// @brief This function splits the next argument off a record of the journal, arguments are separated by one space.
+/// @param arguments rest of the record, NULL if there are no arguments left, it is moved behind the argument
+/// @return the argument, NULL if there are no arguments left
+char* nextRecordArgument(char** arguments)
 {
-  printf("\nPlease enter one of the following commands:\n");
-  printf("  enrol  - enrol new student to the lecture\n");
-  printf("  remove - remove a student from the lecture\n");
-  printf("  give   - give points to a student\n");
-  printf("  calc   - calculate the grades for every student\n");
-  printf("  print  - print the lecture\n");
-  printf("  export - export the lecture to a file\n");
-  printf("  close  - close the lecture\n");
+  char* argument = *arguments;
+  if(argument != NULL)
+  {
+    *arguments = strchr(argument, ' ');
+    if(*arguments != NULL)
+    {
+      *(*arguments)++ = '\0';
+    }
+  }
+  return argument;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function checks number of arguments for each command in the lecture mode.
-/// @param command value of a command
-/// @param token_2 second argument
-/// @param token_3 third argument
-/// @param token_4 fourth argument
-/// @return 0 on success, WRONG_ARGUMENT if number of the arguments for a specific function is wrong
-int checkNumberArgumentsLecture(int command, char* token_2, char* token_3, char* token_4)
+/// @brief This function applies one record of the journal (see startJournalRecord) to the lecture. Every student is
+/// checked silently first, because a wrong record only means that the journal is damaged.
+/// @param lecture lecture, its journal is not started, so nothing is written to it again
+/// @param record record without '\n'
+/// @return 0 on success, MALFORMED_ROW if the record is wrong, MEMORY_ERROR if allocation failed
+int replayRecord(Lecture* lecture, char* record)
 {
-  if(command == ENROL || command == REMOVE)//1 parameter(student name)
+  char* arguments = record;
+  char* command = nextRecordArgument(&arguments);
+  char* argument = NULL;
+  if(strcmp(command, "enrol") == 0)
   {
-    if(token_3 != NULL)
-    {
-      printf("Error: Invalid command usage!\n");
-      return WRONG_ARGUMENT;
-    }
-    if(token_2 == NULL)
+    while((argument = nextRecordArgument(&arguments)) != NULL)
     {
-      printf("Error: Invalid command usage!\n");
-      return WRONG_ARGUMENT;
+      if(*argument == '\0' || !validStudentsName(argument, strlen(argument)) ||
+         studentNameInLecture(lecture, argument) != NO_STUDENT)
+      {
+        return MALFORMED_ROW;
+      }
+      if(enrol(lecture, argument) == MEMORY_ERROR)
+      {
+        return MEMORY_ERROR;
+      }
     }
+    return 0;
   }
-  if(command == GIVE)//2 parameters(points, student name)
+  if(strcmp(command, "give") == 0)
   {
-    if(token_4 != NULL)
-    {
-      printf("Error: Invalid command usage!\n");
-      return WRONG_ARGUMENT;
-    }
-    if(token_3 == NULL)
+    while((argument = nextRecordArgument(&arguments)) != NULL)
     {
-      printf("Error: Invalid command usage!\n");
-      return WRONG_ARGUMENT;
+      char* name = nextRecordArgument(&arguments);
+      bool add = true;
+      int points = *argument == '\0' ? WRONG_ARGUMENT : extractAndCheckPoints(argument, &add);
+      int student_index = name == NULL ? NO_STUDENT : studentNameInLecture(lecture, name);
+      if(points == WRONG_ARGUMENT || student_index == NO_STUDENT ||
+         pointsLimit(lecture, student_index, points, add) == POINTS_LIMIT)
+      {
+        return MALFORMED_ROW;
+      }
+      invalidateGrades(lecture);
+      givePointsToStudent(lecture, points, student_index, add);
     }
+    return 0;
+  }
+  if(strcmp(command, "remove") != 0 || arguments == NULL)
+  {
+    return MALFORMED_ROW;
   }
-  if(command == CALC || command == PRINT || command == EXPORT || command == CLOSE)//no parameters
+  bool swap = strncmp(arguments, "--swap ", 7) == 0;
+  Arguments names = splitArguments(arguments + (swap ? 7 : 0));
+  if(names.amount_ == 0)
   {
-    if(token_2 != NULL)
+    return MALFORMED_ROW;
+  }
+  Arguments remaining_names = names;
+  while((argument = nextArgument(&remaining_names)) != NULL)
+  {
+    if(studentNameInLecture(lecture, argument) == NO_STUDENT)
     {
-      printf("Error: Invalid command usage!\n");
-      return WRONG_ARGUMENT;
+      return MALFORMED_ROW;
     }
   }
-  return 0;
+  int result = removeStudents(lecture, names, swap);
+  return result == 0 || result == MEMORY_ERROR ? result : MALFORMED_ROW;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function tokenises input of the user, identifies value of the command and checks number of arguments.
-/// @param input user input
-/// @param token_1 command
-/// @param token_2 second argument
-/// @param token_3 third argument
-/// @param token_4 fourth argument
-/// @return command on success, QUIT if user typed "exit", WRONG_ARGUMENT if number of the arguments is wrong
-int getAndCheckArgumentsLecture(char** input, char** token_1, char** token_2, char** token_3, char** token_4)
+/// @brief This function replays the journal after the lecture was loaded from its report, so that changes made since
+/// the last export or compaction are not lost when the program ends without an export or crashes. The journal belongs
+/// to the report only if the checksum in its first line matches, otherwise the program ended while the report was
+/// compacted and the report already has every change. A record without '\n' or a wrong record ends the replay; the
+/// program ended while it was written, so the journal is cut off there. Then the journal goes on after the replayed
+/// records. If the lecture is loaded from another file, it is not journaled, the journal is kept and a warning says
+/// where to load it from.
+/// @param lecture lecture that was just loaded, nothing is journaled yet
+/// @param path path the lecture was loaded from
+/// @return 0 on success, MEMORY_ERROR if allocation failed
+int recoverJournal(Lecture* lecture, char* path)
 {
-  *token_1 = strtok(*input, " \t\v");
-  *token_2 = strtok(NULL, " \t\v");
-  *token_3 = strtok(NULL, " \t\v");
-  *token_4 = strtok(NULL, " \t\v");
-  int command = identifyCommand(*token_1);
-  if(command == QUIT && *token_2 ==  NULL)
+  struct stat loaded_status;
+  struct stat report_status;
+  bool report = stat(lecture->report_path_, &report_status) == 0;
+  JournalBase base = report && stat(path, &loaded_status) == 0 && loaded_status.st_dev == report_status.st_dev &&
+                     loaded_status.st_ino == report_status.st_ino ? REPORT_BASE : NO_BASE;
+  FILE* file = fopen(lecture->journal_path_, "r+");
+  struct stat file_status;
+  if(file == NULL || fstat(fileno(file), &file_status) != 0)
   {
-    return QUIT;
+    if(file != NULL)
+    {
+      fclose(file);
+    }
+    lecture->journal_.base_ = base;
+    return 0;
   }
-  if(command == QUIT && *token_2 !=  NULL)
+  char* records = malloc(file_status.st_size + 1);
+  if(records == NULL)
   {
-    printf("Error: Invalid command usage!\n");
-    return WRONG_ARGUMENT;
+    fclose(file);
+    return MEMORY_ERROR;
   }
-  if(command == UNKNOWN_COMMAND)
+  long size = fread(records, 1, file_status.st_size, file);
+  records[size] = '\0';
+  char* record = strchr(records, '\n');
+  unsigned int journal_checksum = 0;
+  uint32_t report_checksum = 0;
+  bool current = record != NULL && sscanf(records, "A4 journal %u", &journal_checksum) == 1 && report &&
+                 fileChecksum(lecture->report_path_, &report_checksum) && report_checksum == journal_checksum;
+  if(!current || base == NO_BASE)
   {
-    printf("Error: Unknown command!\n");
-    return WRONG_ARGUMENT;
+    if(current && record[1] != '\0')
+    {
+      printf("Warning: Journal of lecture %s was not replayed, load %s to recover its changes!\n", lecture->name_,
+             lecture->report_path_);
+    }
+    free(records);
+    fclose(file);
+    lecture->journal_.base_ = base;//an outdated journal is replaced when the lecture changes
+    return 0;
   }
-  if(command == CREATE || command == LOAD)
+  int result = 0;
+  long replayed_records = 0;
+  char* newline = NULL;
+  for(record++; (newline = strchr(record, '\n')) != NULL; record = newline + 1)
   {
-    printf("Error: This command cannot be used in the current mode!\n");
-    return WRONG_ARGUMENT;
+    *newline = '\0';
+    result = replayRecord(lecture, record);
+    if(result != 0)
+    {
+      break;
+    }
+    replayed_records++;
+  }
+  long replayed_size = record - records;
+  free(records);
+  if(result == MEMORY_ERROR)
+  {
+    fclose(file);
+    return MEMORY_ERROR;
   }
-  if(checkNumberArgumentsLecture(command, *token_2, *token_3, *token_4) == WRONG_ARGUMENT)
+  if(replayed_size < size)
   {
-    return WRONG_ARGUMENT;
+    printf("Warning: Journal of lecture %s is damaged after %ld commands, the rest was dropped!\n", lecture->name_,
+           replayed_records);
+  }
+  lecture->journal_.base_ = base;
+  if((replayed_size < size && ftruncate(fileno(file), replayed_size) != 0) || fseek(file, 0, SEEK_END) != 0)
+  {
+    fclose(file);
+    stopJournal(lecture);
+    return 0;
+  }
+  lecture->journal_.file_ = file;
+  lecture->journal_.records_ = replayed_records;
+  if(replayed_records > 0)
+  {
+    printf("Recovered %ld commands of lecture %s from its journal.\n", replayed_records, lecture->name_);
   }
-  return command;
+  return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function searches for a student in the lecture using the name of the student.
+/// @brief This function counts the bytes a lecture uses for its students the same way as the command memory: student
+/// records, columns of points and grades, the arena, the name index, the sorted orders and the changed points.
 /// @param lecture lecture
-/// @param name name of the target student
-/// @return index of the target student in the students array of the lecture on success, STUDENT_NOT_FOUND on failure
-int studentNameInLecture(Lecture* lecture, char* name)
+/// @return amount of bytes
+long lectureMemory(Lecture* lecture)
 {
-  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  long changed_points = lecture->changed_points_ == NULL ? 0 : (lecture->amount_students_ / 64 + 1) * sizeof(uint64_t);
+  long arena = 0;
+  for(NameBlock* block = lecture->name_blocks_; block != NULL; block = block->next_)
   {
-    if(strcmp(name, (lecture->students_ + student_index)->name_) == 0)
-    {
-      return student_index;
-    }
+    arena += block->size_;
   }
-  return STUDENT_NOT_FOUND;
+  return (long)lecture->capacity_ * (sizeof(Student) + sizeof(*lecture->points_) + sizeof(*lecture->grades_)) + arena +
+         (long)lecture->name_index_capacity_ * sizeof(int) +
+         (long)(lecture->points_order_.length_ + lecture->names_order_.length_) * sizeof(int) + changed_points;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function represents a command enrol. It checks the name of the student and whether there already is a
-/// student with such a name. Then it reallocates array of students, adds a new student there and initialises points 
-/// and grade of that student.
+/// @brief This function represents a command memory. It prints how many bytes the lecture uses for its students, split
+/// into the student records with short names, the columns of points and grades, the arena with long names, the name
+/// index and the cached sorted orders, and how many bytes that is per student. Bookkeeping of malloc itself is not
+/// counted. Long names of removed students stay in the arena until the lecture is closed, they are counted as used.
+/// At the end it prints how many other lectures are in memory and the memory budget.
+/// @param registry registry of the open lectures
 /// @param lecture lecture
-/// @param name name of the new student
-/// @return 0 on success, MEMORY_ERROR if (re)allocation failed, other values if name is invalid or name is not unique
-int enrol(Lecture* lecture, char* name)
+void printMemoryReport(Registry* registry, Lecture* lecture)
 {
-  if(checkStudentsName(name) == INCORRECT_STUDENTS_NAME)
+  long records = (long)lecture->capacity_ * sizeof(Student);
+  long columns = (long)lecture->capacity_ * (sizeof(*lecture->points_) + sizeof(*lecture->grades_));
+  int amount_blocks = 0;
+  long arena = 0;
+  long arena_used = 0;
+  for(NameBlock* block = lecture->name_blocks_; block != NULL; block = block->next_)
   {
-    return INCORRECT_STUDENTS_NAME;
+    amount_blocks++;
+    arena += block->size_;
+    arena_used += block->used_;
+  }
+  long name_index = (long)lecture->name_index_capacity_ * sizeof(int);
+  long sorted_orders = (long)(lecture->points_order_.length_ + lecture->names_order_.length_) * sizeof(int);
+  long total = lectureMemory(lecture);
+  printf("+===========================+\n");
+  printf("Memory of lecture: %s\n", lecture->name_);
+  printf("Students: %d (space for %d)\n", lecture->amount_students_, lecture->capacity_);
+  printf("Student records: %ld bytes\n", records);
+  printf("Points and grades: %ld bytes\n", columns);
+  printf("Arena: %ld bytes in %d blocks, %ld bytes used\n", arena, amount_blocks, arena_used);
+  printf("Name index: %ld bytes\n", name_index);
+  printf("Sorted orders: %ld bytes\n", sorted_orders);
+  if(lecture->changed_points_ != NULL)
+  {
+    printf("Changed points: %ld bytes\n", (lecture->amount_students_ / 64 + 1) * (long)sizeof(uint64_t));
   }
-  if(studentNameInLecture(lecture, name) != STUDENT_NOT_FOUND)
+  printf("Total: %ld bytes\n", total);
+  if(lecture->amount_students_ != 0)
   {
-    printf("Error: Student already exists, please enter another name!\n");
-    return NOT_UNIQUE_NAME;
+    printf("Per student: %.2f bytes\n", (double)total / lecture->amount_students_);
   }
-  lecture->amount_students_++;
-  lecture->students_ = realloc(lecture->students_, lecture->amount_students_ * sizeof(Student));
-  if(lecture->students_ == NULL)
+  int other_lectures = 0;
+  for(RegisteredLecture* entry = registry->newest_; entry != NULL; entry = entry->older_)
   {
-    return MEMORY_ERROR;
+    other_lectures += entry != registry->current_;
   }
-  int name_length = strlen(name) + 1;//+1 for \0
-  (lecture->students_ + lecture->amount_students_ - 1)->name_ = malloc(name_length * sizeof(char));
-  if((lecture->students_ + lecture->amount_students_ - 1)->name_ == NULL)
+  printf("Other lectures in memory: %d, %ld bytes\n", other_lectures, registry->resident_memory_);
+  if(registry->budget_ != 0)
   {
-    return MEMORY_ERROR;
+    printf("Memory budget: %ld bytes\n", registry->budget_);
   }
-  strcpy((lecture->students_ + lecture->amount_students_ - 1)->name_, name);// -1 because index
-  (lecture->students_ + lecture->amount_students_ - 1)->points_ = 0;//we need to do that because realloc gives
-  (lecture->students_ + lecture->amount_students_ - 1)->grade_ = 0;// us new memory with random values in it
-  return 0;
+  printf("+===========================+\n");
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function deletes grades of all students and average grade.
-/// @param lecture lecture
-void deleteGradesAndAverage(Lecture* lecture)
+/// @brief This function finds the slot of a lecture in the registry, or the empty slot where it would be.
+/// @param registry registry of the open lectures, its table must exist
+/// @param name name of the lecture
+/// @return slot in the table
+int findRegistrySlot(Registry* registry, char* name)
 {
-  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  int mask = registry->capacity_ - 1;
+  int slot = hashName(name) & mask;
+  while(registry->table_[slot] != NULL && strcmp(registry->table_[slot]->name_, name) != 0)
   {
-    (lecture->students_ + student_index)->grade_ = 0;
+    slot = (slot + 1) & mask;
   }
-  lecture->average_grade_ = 0;
+  return slot;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This program "deletes" target student by shifting all of the students after that student to the left by 1
-/// position.
-/// @param lecture lecture
-/// @param student_index index of the target student
-void moveStudents(Lecture* lecture, int student_index)
+/// @brief This function doubles the table of the registry, lectures are never removed from it, so it only grows.
+/// @param registry registry of the open lectures
+/// @return 0 on success, MEMORY_ERROR if allocation failed
+int growRegistry(Registry* registry)
 {
-  free((lecture->students_ + student_index)->name_);
-  for(; student_index < lecture->amount_students_ - 1; student_index++)
+  int old_capacity = registry->capacity_;
+  RegisteredLecture** old_table = registry->table_;
+  int capacity = old_capacity == 0 ? NAME_INDEX_INITIAL_CAPACITY : 2 * old_capacity;
+  RegisteredLecture** table = calloc(capacity, sizeof(RegisteredLecture*));
+  if(table == NULL)
+  {
+    return MEMORY_ERROR;
+  }
+  registry->table_ = table;
+  registry->capacity_ = capacity;
+  for(int slot = 0; slot < old_capacity; slot++)
   {
-    (lecture->students_ + student_index)->name_ = (lecture->students_ + student_index + 1)->name_;
-    (lecture->students_ + student_index)->grade_ = (lecture->students_ + student_index + 1)->grade_;
-    (lecture->students_ + student_index)->points_ = (lecture->students_ + student_index + 1)->points_;
+    if(old_table[slot] != NULL)
+    {
+      registry->table_[findRegistrySlot(registry, old_table[slot]->name_)] = old_table[slot];
+    }
   }
-  (lecture->students_ + student_index)->name_ = NULL;//no + 1 because it is now = lecture->amount_students_ - 1
-  lecture->amount_students_--;                       //which is exactly last student
+  free(old_table);
+  return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function represents a command remove. It finds a target student, deletes all grades and average grade,
-/// removes target student, reallocates array of the students to free unused memory.
-/// @param lecture lecture
-/// @param name name of the target student
-/// @return 0 on success, STUDENT_NOT_FOUND on failure, MEMORY_ERROR if realloc fails
-int removeStudent(Lecture* lecture, char* name)
+/// @brief This function creates an entry of the registry for a lecture with the given name, without the lecture.
+/// @param name name of the lecture
+/// @return the entry, NULL if allocation failed
+RegisteredLecture* newRegisteredLecture(char* name)
 {
-  int student_index = studentNameInLecture(lecture, name);
-  if(student_index == STUDENT_NOT_FOUND)
-  {
-    printf("Error: Student not found!\n");
-    return STUDENT_NOT_FOUND;
-  }
-  deleteGradesAndAverage(lecture);
-  moveStudents(lecture, student_index);
-  if(lecture->amount_students_ == 0)
+  int name_length = strlen(name);
+  RegisteredLecture* entry = calloc(1, sizeof(RegisteredLecture));
+  char* strings = malloc(3 * name_length + 34);//name, reports/..bin and reports/..bin.tmp with their '\0'
+  if(entry == NULL || strings == NULL)
   {
-    free(lecture->students_);
-    lecture->students_ = NULL;
-    return 0;
+    free(entry);
+    free(strings);
+    return NULL;
   }
-  lecture->students_ = realloc(lecture->students_, lecture->amount_students_ * sizeof(Student));
-  if(lecture->students_ == NULL)//no need for temporary pointer because we exit if allocation has failed
+  entry->name_ = strings;
+  entry->spill_path_ = strings + name_length + 1;
+  entry->spill_temp_path_ = entry->spill_path_ + name_length + 14;
+  strcpy(entry->name_, name);
+  sprintf(entry->spill_path_, "reports/.%s.bin", name);
+  sprintf(entry->spill_temp_path_, "reports/.%s.bin.tmp", name);
+  return entry;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function takes a lecture out of the list of lectures in memory.
+/// @param registry registry of the open lectures
+/// @param entry entry of the lecture, it has to be in the list
+void unlinkLecture(Registry* registry, RegisteredLecture* entry)
+{
+  *(entry->newer_ == NULL ? &registry->newest_ : &entry->newer_->older_) = entry->older_;
+  *(entry->older_ == NULL ? &registry->oldest_ : &entry->older_->newer_) = entry->newer_;
+  entry->newer_ = NULL;
+  entry->older_ = NULL;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function evicts a lecture that is in memory but not the current one: it is written to its spill file
+/// as a snapshot and freed, and only its name and the state of its grades stay in the registry.
+/// @param registry registry of the open lectures
+/// @param entry entry of the lecture
+/// @return 0 on success, FILE_ERROR or WRITE_ERROR if the snapshot could not be written, then the lecture stays
+int evictLecture(Registry* registry, RegisteredLecture* entry)
+{
+  uint32_t checksum = 0;
+  int result = writeSnapshot(entry->lecture_, entry->spill_path_, entry->spill_temp_path_, &checksum);
+  if(result != 0)
   {
-    return MEMORY_ERROR;
+    return result;
   }
+  entry->grades_state_ = entry->lecture_->grades_state_;
+  entry->average_grade_ = entry->lecture_->average_grade_;
+  entry->journal_ = entry->lecture_->journal_;
+  entry->lecture_->journal_.file_ = NULL;
+  registry->resident_memory_ -= entry->memory_;
+  unlinkLecture(registry, entry);
+  freeLecture(entry->lecture_);
+  entry->lecture_ = NULL;
   return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function receives an array of characters, that represent points. This array can also have '-' to
-/// substract points. Then function checks whether we need to add or substract them, checks whether they are valid 
-/// characters and converts them to an integer.
-/// @param points array that represent points
-/// @param add logical variable to add/substract
-/// @return number points on success, WRONG_ARGUMENT on failure
-int extractAndCheckPoints(char* points, bool* add)
+/// @brief This function evicts the least recently used lectures until all lectures in memory fit into the memory
+/// budget. The current lecture is never evicted, lectures that cannot be written stay in memory.
+/// @param registry registry of the open lectures
+void enforceMemoryBudget(Registry* registry)
 {
-  int points_number = 0;
-  int points_length = strlen(points);
-  if(*points == '-')
-  {
-    *add = false;//substract points
-    if(points_length > 4)
-    {
-      return WRONG_ARGUMENT;
-    }
-    for(int points_index = 1 ; points_index < points_length; points_index++)
-    {
-      if(isdigit(*(points + points_index)) == 0)
-      {
-        return WRONG_ARGUMENT;
-      }
-    }
-    points_number = atoi(points + 1);
-    if(points_number > 100 || points_number < 0)
-    {
-      return WRONG_ARGUMENT;
-    }
-    return points_number;
-  }
-  *add = true;//add points
-  if(points_length > 3)
+  if(registry->budget_ == 0)
   {
-    return WRONG_ARGUMENT;
+    return;
   }
-  for(int points_index = 0 ; points_index < points_length; points_index++)
+  long current_memory = registry->current_ == NULL ? 0 : lectureMemory(registry->current_->lecture_);
+  RegisteredLecture* entry = registry->oldest_;
+  while(entry != NULL && registry->resident_memory_ + current_memory > registry->budget_)
   {
-    if(isdigit(*(points + points_index)) == 0)
+    RegisteredLecture* newer = entry->newer_;
+    if(entry != registry->current_ && evictLecture(registry, entry) != 0)
     {
-      return WRONG_ARGUMENT;
+      printf("Warning: Lecture %s could not be evicted, memory budget is exceeded!\n", entry->name_);
     }
+    entry = newer;
   }
-  points_number = atoi(points);
-  if(points_number > 100 || points_number < 0)
-  {
-    return WRONG_ARGUMENT;
-  }
-  return points_number;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function checks whether the operation with points will cause points of a target student to exceed the
-/// limit.
-/// @param lecture lecture
-/// @param student_index target student
-/// @param points number of points
-/// @param add logical variable to add/substract
-/// @return number points on success, POINTS_LIMIT on failure
-int pointsLimit(Lecture* lecture, int student_index, int points, bool add)
+/// @brief This function makes a lecture in memory the current one and the most recently used one, then lectures are
+/// evicted if the budget is exceeded. The previous current lecture stays in memory, its size is counted now, because
+/// it does not change any more until it is used again.
+/// @param registry registry of the open lectures
+/// @param entry entry of the lecture, the lecture has to be in memory
+void makeCurrentLecture(Registry* registry, RegisteredLecture* entry)
 {
-  if((lecture->students_ + student_index)->points_ + points > 100 && add)
+  if(registry->current_ == entry)
   {
-    return POINTS_LIMIT;
+    return;
   }
-  if((lecture->students_ + student_index)->points_ - points < 0 && !add)
+  if(registry->current_ != NULL)
   {
-    return POINTS_LIMIT;
+    registry->current_->memory_ = lectureMemory(registry->current_->lecture_);
+    registry->resident_memory_ += registry->current_->memory_;
   }
-  return 0;
+  if(entry->newer_ != NULL || registry->newest_ == entry)//in the list already
+  {
+    registry->resident_memory_ -= entry->memory_;
+    unlinkLecture(registry, entry);
+  }
+  entry->older_ = registry->newest_;
+  *(registry->newest_ == NULL ? &registry->oldest_ : &registry->newest_->newer_) = entry;
+  registry->newest_ = entry;
+  registry->current_ = entry;
+  enforceMemoryBudget(registry);
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function adds/substracts certain amount of points to/from a target student.  
-/// @param lecture lecture
-/// @param points number of points to add/substract
-/// @param student_index target student
-/// @param add logical variable to add/substract
-void givePointsToStudent(Lecture* lecture, int points, int student_index, bool add)
+/// @brief This function adds a created or loaded lecture to the registry and makes it the current one. A lecture with
+/// the same name that is still open is dropped, like it was closed before in a program with one lecture.
+/// @param registry registry of the open lectures
+/// @param lecture lecture, the registry takes care of it from now on, also if allocation fails
+/// @return 0 on success, MEMORY_ERROR if allocation failed
+int registerLecture(Registry* registry, Lecture* lecture)
 {
-  if(add)
+  if((registry->amount_lectures_ + 1) * 2 > registry->capacity_ && growRegistry(registry) == MEMORY_ERROR)
   {
-    (lecture->students_ + student_index)->points_ += points;
-    return;
+    freeLecture(lecture);
+    return MEMORY_ERROR;
   }
-  if(!add)
+  int slot = findRegistrySlot(registry, lecture->name_);
+  RegisteredLecture* entry = registry->table_[slot];
+  if(entry == NULL)
   {
-    (lecture->students_ + student_index)->points_ -= points;
-    return;
+    entry = newRegisteredLecture(lecture->name_);
+    if(entry == NULL)
+    {
+      freeLecture(lecture);
+      return MEMORY_ERROR;
+    }
+    registry->table_[slot] = entry;
+    registry->amount_lectures_++;
   }
+  else if(entry->lecture_ != NULL)//it is not the current one, there is none in the global mode
+  {
+    registry->resident_memory_ -= entry->memory_;
+    unlinkLecture(registry, entry);
+    freeLecture(entry->lecture_);
+  }
+  else
+  {
+    closeJournal(&entry->journal_);
+    remove(entry->spill_path_);
+  }
+  entry->lecture_ = lecture;
+  makeCurrentLecture(registry, entry);
+  return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This fucntion represents a command give. It extracts points from an argument, finds a target student, 
-/// checks the points limit, deletes grades and average and gives/substracts points to/from the target student.
-/// @param lecture lecture
-/// @param points argument which is responsible for points
-/// @param name name of the target student
-/// @return 0 on success, WRONG_ARGUMENT on failure
-int give(Lecture* lecture, char* points, char* name)
+/// @brief This function loads an evicted lecture from its spill file again and restores the state of its grades. The
+/// snapshot has the grades that print showed, so calculated grades do not need calc --lazy any more.
+/// @param entry entry of the lecture
+/// @return 0 on success, FILE_ERROR if the file could not be read, MEMORY_ERROR if allocation failed, MALFORMED_ROW
+/// if the file is damaged
+int reloadLecture(RegisteredLecture* entry)
 {
-  bool add =  true;
-  int points_number = extractAndCheckPoints(points, &add);
-  if(points_number == WRONG_ARGUMENT)
+  FILE* file = fopen(entry->spill_path_, "rb");
+  if(file == NULL)
   {
-    printf("Error: Invalid command usage!\n");
-    return WRONG_ARGUMENT;
+    printf("Error: Cannot open file: %s!\n", entry->spill_path_);
+    return FILE_ERROR;
   }
-  int student_index = studentNameInLecture(lecture, name);
-  if(student_index == STUDENT_NOT_FOUND)
+  Lecture* lecture = NULL;
+  int result = createLecture(entry->name_, strlen(entry->name_), &lecture);
+  if(result == 0)
   {
-    printf("Error: Student not found!\n");
-    return WRONG_ARGUMENT;
+    result = loadSnapshot(file, lecture, entry->spill_path_);
   }
-  if(pointsLimit(lecture, student_index, points_number, add) == POINTS_LIMIT)
+  fclose(file);
+  if(result != 0)
   {
-    printf("Error: Points limit exceeded!\n");
-    return WRONG_ARGUMENT;
+    return result;
   }
-  deleteGradesAndAverage(lecture);
-  givePointsToStudent(lecture, points_number, student_index, add);
+  countLoadedStudents(lecture);
+  lecture->grades_state_ = entry->grades_state_;
+  lecture->average_grade_ = entry->average_grade_;
+  lecture->graded_students_ = lecture->amount_students_;
+  lecture->journal_ = entry->journal_;
+  entry->journal_.file_ = NULL;
+  remove(entry->spill_path_);
+  entry->lecture_ = lecture;
   return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function iterates through all the students and finds the highest amount of points among them.
-/// @param lecture lecture
-/// @return highest amount of points
-int findHighestPoints(Lecture* lecture)
+/// @brief This function represents a command use. It finds an open lecture by its name in O(1), loads it again if it
+/// was evicted, makes it the current one and changes mode to the lecture mode.
+/// @param registry registry of the open lectures
+/// @param name name of the lecture
+/// @param global_mode logical variable, represents a global or lecture mode
+/// @return 0 on success, WRONG_ARGUMENT if there is no such lecture or it could not be loaded, MEMORY_ERROR if
+/// allocation failed
+int useLecture(Registry* registry, char* name, bool* global_mode)
 {
-  int highest_points = 0;
-  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  RegisteredLecture* entry = registry->table_ == NULL ? NULL : registry->table_[findRegistrySlot(registry, name)];
+  if(entry == NULL)
+  {
+    printf("Error: Lecture not found!\n");
+    return WRONG_ARGUMENT;
+  }
+  if(entry->lecture_ == NULL)
   {
-    if((lecture->students_ + student_index)->points_ > highest_points)
+    int result = reloadLecture(entry);
+    if(result != 0)
     {
-      highest_points = (lecture->students_ + student_index)->points_;
+      return result == MEMORY_ERROR ? MEMORY_ERROR : WRONG_ARGUMENT;
     }
   }
-  return highest_points;
+  makeCurrentLecture(registry, entry);
+  *global_mode = false;
+  return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function calculates average grade in the lecture.
-/// @param lecture lecture
-/// @return average grade
-float calculateAverageGrade(Lecture* lecture)
+/// @brief This function represents a command close. The lecture stays open, it is only evicted from memory and loaded
+/// again when it is used next time. If it cannot be evicted it stays in memory, a warning is printed only if that
+/// exceeds the memory budget (see enforceMemoryBudget). Then the mode changes to the global.
+/// @param registry registry of the open lectures
+/// @param global_mode logical variable, represents a global or lecture mode
+void closeLecture(Registry* registry, bool* global_mode)
 {
-  float total = 0;
-  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  RegisteredLecture* entry = registry->current_;
+  entry->memory_ = lectureMemory(entry->lecture_);
+  registry->resident_memory_ += entry->memory_;
+  registry->current_ = NULL;
+  if(evictLecture(registry, entry) != 0)
   {
-    total += (lecture->students_ + student_index)->grade_;
+    enforceMemoryBudget(registry);//it may stay in memory as long as the budget holds
   }
-  float average_grade = total / lecture->amount_students_;
-  return average_grade;
+  *global_mode = true;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function assigns a grade to each student according to the highest number of points in the lecture.
-/// @param lecture lecture
-void calc(Lecture* lecture)
+/// @brief This function frees all lectures of the registry and removes the spill files of the evicted ones.
+/// @param registry registry of the open lectures
+void freeRegistry(Registry* registry)
 {
-  if(lecture->amount_students_ == 0)
-  {
-    return;
-  }
-  int highest_points = findHighestPoints(lecture);
-  if(highest_points == 0)
-  {
-    for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
-    {
-      (lecture->students_ + student_index)->grade_ = 1;
-    }
-    lecture->average_grade_ = 1;
-    return;
-  }
-  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  for(int slot = 0; slot < registry->capacity_; slot++)
   {
-    int percentage = (lecture->students_ + student_index)->points_ * 100 / highest_points;
-    if(percentage >= 87)
-    {
-      (lecture->students_ + student_index)->grade_ = 1;
-      continue;
-    }
-    if(percentage >= 75)
+    RegisteredLecture* entry = registry->table_[slot];
+    if(entry == NULL)
     {
-      (lecture->students_ + student_index)->grade_ = 2;
       continue;
     }
-    if(percentage >= 62)
+    if(entry->lecture_ != NULL)
     {
-      (lecture->students_ + student_index)->grade_ = 3;
-      continue;
-    }
-    if(percentage >= 51)
-    {
-      (lecture->students_ + student_index)->grade_ = 4;
-      continue;
+      freeLecture(entry->lecture_);
     }
-    if(percentage < 51)
+    else
     {
-      (lecture->students_ + student_index)->grade_ = 5;
-      continue;
+      closeJournal(&entry->journal_);
+      remove(entry->spill_path_);
     }
+    free(entry->name_);
+    free(entry);
   }
-  lecture->average_grade_ = calculateAverageGrade(lecture);
-  return;
+  free(registry->table_);
+  registry->table_ = NULL;
+  registry->capacity_ = 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function prints average grade and students with their grades.
-/// @param lecture lecture
-void printWithGrades(Lecture* lecture)
+/// @brief This function represents a command create. Lecture is created empty, an older journal of the same name is
+/// removed, and the lecture is added to the registry of open lectures. It is not journaled until it is exported.
+/// @param session session, its registry holds the lectures
+/// @param arguments name of the lecture
+/// @param global_mode logical variable, represents a global or lecture mode
+/// @return LECTURE_CREATED on success, INCORRECT_LECTURE_NAME if the name is invalid, MEMORY_ERROR if allocation failed
+int executeCreate(Session* session, Arguments arguments, bool* global_mode)
 {
-  printf("Average Grade: %.2f\n", lecture->average_grade_);
-  printf("+===========================+\n");
-  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  char* name = nextArgument(&arguments);
+  Lecture* lecture = NULL;
+  int result = createLecture(name, strlen(name), &lecture);
+  if(result == INCORRECT_LECTURE_NAME)
   {
-    printf("Name: %s\n", (lecture->students_ + student_index)->name_);
-    printf("Points: %d\n", (lecture->students_ + student_index)->points_);
-    printf("Grade: %d\n", (lecture->students_ + student_index)->grade_);
-    printf("+---------------------------+\n");
+    return INCORRECT_LECTURE_NAME;//start again
   }
+  if(result == MEMORY_ERROR)
+  {
+    return MEMORY_ERROR;//end program
+  }
+  remove(lecture->journal_path_);//the new lecture starts over, changes of an older one must never be replayed on it
+  if(registerLecture(&session->registry_, lecture) == MEMORY_ERROR)
+  {
+    return MEMORY_ERROR;
+  }
+  *global_mode = false;
+  return LECTURE_CREATED;//change mode in the loop
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function prints students without their grades.
-/// @param lecture lecture
-void printWithoutGrades(Lecture* lecture)
+/// @brief This function represents a command load, also as load --mmap <path> or load --threads <amount> <path>.
+/// Lecture is loaded with the changes of its journal (see recoverJournal) and added to the registry of open lectures.
+/// @param session session, its registry holds the lectures
+/// @param arguments options and path to the file
+/// @param global_mode logical variable, represents a global or lecture mode
+/// @return FILE_LOADED on success, UNSUCCESSFUL_LOAD if the file could not be loaded, MEMORY_ERROR if allocation failed
+int executeLoad(Session* session, Arguments arguments, bool* global_mode)
 {
-  printf("+===========================+\n");
-  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  int amount_threads = 0;//file is read, not mapped
+  char* path = nextArgument(&arguments);
+  if(strcmp(path, "--mmap") == 0)
+  {
+    amount_threads = 1;
+    path = nextArgument(&arguments);
+  }
+  else if(strcmp(path, "--threads") == 0)
+  {
+    amount_threads = checkAmountThreads(nextArgument(&arguments));
+    path = nextArgument(&arguments);
+  }
+  Lecture* lecture = NULL;
+  int load_result = loadLecture(path, &lecture, amount_threads);
+  if(load_result == MEMORY_ERROR)
+  {
+    return MEMORY_ERROR;//end program
+  }
+  if(load_result != 0)
+  {
+    return UNSUCCESSFUL_LOAD;//start again
+  }
+  if(recoverJournal(lecture, path) == MEMORY_ERROR)
+  {
+    freeLecture(lecture);
+    return MEMORY_ERROR;
+  }
+  if(registerLecture(&session->registry_, lecture) == MEMORY_ERROR)
   {
-    printf("Name: %s\n", (lecture->students_ + student_index)->name_);
-    printf("Points: %d\n", (lecture->students_ + student_index)->points_);
-    printf("+---------------------------+\n");
+    return MEMORY_ERROR;
   }
+  *global_mode = false;
+  return FILE_LOADED;//change mode in the loop
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function prints students with their grades but without an average grade of the lecture.
-/// @param lecture lecture
-void printWithoutAverage(Lecture* lecture)
+/// @brief This function represents a command use in both modes, see useLecture.
+/// @param session session, its registry holds the lectures
+/// @param arguments name of the lecture
+/// @param global_mode logical variable, represents a global or lecture mode
+/// @return 0 on success, WRONG_ARGUMENT if the lecture could not be used, MEMORY_ERROR if allocation failed
+int executeUse(Session* session, Arguments arguments, bool* global_mode)
 {
-  printf("+===========================+\n");
-  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  return useLecture(&session->registry_, nextArgument(&arguments), global_mode);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents a command enrol in the lecture mode, enrol <name> or enrol --from <roster>. A
+/// successful change is committed to the journal.
+/// @param session session, the command works on its current lecture
+/// @param arguments name of the student, or --from and the path to the roster
+/// @param global_mode unused
+/// @return 0 on success, WRONG_ARGUMENT if a student could not be enrolled, MEMORY_ERROR if allocation failed
+int executeEnrol(Session* session, Arguments arguments, bool* global_mode)
+{
+  (void)global_mode;
+  Lecture* lecture = session->registry_.current_->lecture_;
+  char* name = nextArgument(&arguments);
+  int result = strcmp(name, "--from") == 0 ? enrolFromRoster(lecture, nextArgument(&arguments)) : enrol(lecture, name);
+  if(result == MEMORY_ERROR)
   {
-    printf("Name: %s\n", (lecture->students_ + student_index)->name_);
-    printf("Points: %d\n", (lecture->students_ + student_index)->points_);
-    printf("Grade: %d\n", (lecture->students_ + student_index)->grade_);
-    printf("+---------------------------+\n");
+    return MEMORY_ERROR;
+  }
+  if(result != 0)//any not memory problem
+  {
+    return WRONG_ARGUMENT;
   }
+  commitJournal(lecture);
+  return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function is responsible for printing lecture info. Depending on whether there is an average grade and
-/// whether students have their grades as well or not it prints grades and average, just grades or it does not print
-/// grades and average at all.
-/// @param lecture lecture
-void print(Lecture* lecture)
+/// @brief This function represents a command remove in the lecture mode, remove [--swap] <names>, with any amount of
+/// names. A successful change is committed to the journal.
+/// @param session session, the command works on its current lecture
+/// @param arguments names of the students, --swap may come first
+/// @param global_mode unused
+/// @return 0 on success, WRONG_ARGUMENT if a student was not found, MEMORY_ERROR if allocation failed
+int executeRemove(Session* session, Arguments arguments, bool* global_mode)
 {
-  printf("+===========================+\n");
-  printf("Lecture: %s\n", lecture->name_);
-  printf("Number of students: %d\n", lecture->amount_students_);
-  if(lecture->amount_students_ != 0 && lecture->average_grade_ == 0.0f && (lecture->students_)->grade_ != 0)
+  (void)global_mode;
+  Lecture* lecture = session->registry_.current_->lecture_;
+  bool swap = strcmp(argumentAt(arguments, 0), "--swap") == 0;
+  if(swap)
   {
-    printWithoutAverage(lecture);
-    return;
+    nextArgument(&arguments);
   }
-  if(lecture->average_grade_ == 0.0f)
+  int result = removeStudents(lecture, arguments, swap);
+  if(result == MEMORY_ERROR)
   {
-    printWithoutGrades(lecture);
-    return;
+    return MEMORY_ERROR;
+  }
+  if(result == STUDENT_NOT_FOUND)
+  {
+    return WRONG_ARGUMENT;
   }
-  printWithGrades(lecture);
+  commitJournal(lecture);
+  return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function writes data from the lecture to the csv file, which it creates. It iterates through all the
-/// students and write them down as rows in csv file.
-/// @param lecture lecture
-/// @return 0 on success, FILE_ERROR if file could not be created, MEMORY_ERROR if alocation failed
-int export(Lecture* lecture)
+/// @brief This function represents a command give in the lecture mode, give <points> <name> or give --from <file>. A
+/// successful change is committed to the journal.
+/// @param session session, the command works on its current lecture
+/// @param arguments points and name of the student, or --from and the path to the file with points
+/// @param global_mode unused
+/// @return 0 on success, WRONG_ARGUMENT if the points could not be given, MEMORY_ERROR if allocation failed
+int executeGive(Session* session, Arguments arguments, bool* global_mode)
 {
-  int lecture_name_length = strlen(lecture->name_);
-  char* file_path = malloc(13 + lecture_name_length * sizeof(char));//reports\\.csv - 12 characters + \0
-  if(file_path == NULL)
+  (void)global_mode;
+  Lecture* lecture = session->registry_.current_->lecture_;
+  char* points = nextArgument(&arguments);
+  char* name = nextArgument(&arguments);
+  int result = strcmp(points, "--from") == 0 ? giveFromFile(lecture, name) : give(lecture, points, name);
+  if(result == MEMORY_ERROR)
   {
     return MEMORY_ERROR;
   }
-  sprintf(file_path, "reports/%s.csv", lecture->name_);//printf, but in string
-  FILE* file = fopen(file_path, "w");
-  free(file_path);
-  if(file == NULL)
+  if(result != 0)
   {
-    printf("Error: Report could not be created!\n");
-    return FILE_ERROR;
+    return WRONG_ARGUMENT;
   }
-  for(int student_index = 0; student_index < lecture->amount_students_; student_index++)
+  commitJournal(lecture);
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents a command calc in the lecture mode, calc or calc --lazy.
+/// @param session session, the command works on its current lecture
+/// @param arguments nothing or --lazy
+/// @param global_mode unused
+/// @return 0
+int executeCalc(Session* session, Arguments arguments, bool* global_mode)
+{
+  (void)global_mode;
+  calc(session->registry_.current_->lecture_, arguments.amount_ > 0);
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents a command print in the lecture mode, see printCommand.
+/// @param session session, the command works on its current lecture
+/// @param arguments options of print
+/// @param global_mode unused
+/// @return 0 on success, WRONG_ARGUMENT if an argument is invalid, MEMORY_ERROR if allocation failed
+int executePrint(Session* session, Arguments arguments, bool* global_mode)
+{
+  (void)global_mode;
+  return printCommand(session->registry_.current_->lecture_, arguments);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents a command export in the lecture mode, export, export --binary or
+/// export --incremental.
+/// @param session session, the command works on its current lecture
+/// @param arguments nothing or the option
+/// @param global_mode unused
+/// @return 0 on success, WRONG_ARGUMENT if the file could not be written, MEMORY_ERROR if allocation failed
+int executeExport(Session* session, Arguments arguments, bool* global_mode)
+{
+  (void)global_mode;
+  Lecture* lecture = session->registry_.current_->lecture_;
+  char* option = nextArgument(&arguments);
+  int result = option == NULL ? export(lecture) : exportBinary(lecture, strcmp(option, "--incremental") == 0);
+  if(result == MEMORY_ERROR)
+  {
+    return MEMORY_ERROR;
+  }
+  if(result == FILE_ERROR)
   {
-    fprintf(file, "%s", (lecture->students_ + student_index)->name_);
-    fprintf(file, ",");
-    fprintf(file, "%d", (lecture->students_ + student_index)->points_);
-    fprintf(file, ",");
-    fprintf(file, "%d", (lecture->students_ + student_index)->grade_);
-    fprintf(file, "\n");
+    return WRONG_ARGUMENT;
   }
-  fclose(file);
   return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function represents a command close. It frees the lecture and changes mode to the global.
-/// @param lecture lecture
+/// @brief This function represents a command close in the lecture mode, see closeLecture.
+/// @param session session, the command works on its current lecture
+/// @param arguments unused
 /// @param global_mode logical variable, represents a global or lecture mode
-void close(Lecture* lecture, bool* global_mode)
+/// @return 0
+int executeClose(Session* session, Arguments arguments, bool* global_mode)
 {
-  freeLecture(lecture);
-  *global_mode = true;
+  (void)arguments;
+  closeLecture(&session->registry_, global_mode);
+  return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function handles the logic of the lecture mode. It executes one of the commands and then takes care of
-/// the returns of the command.
-/// @param lecture lecture
-/// @param token_2 second argument
-/// @param token_3 third argument
-/// @param global_mode logical variable, represents a global or lecture mode
-/// @param command command(first argument)
-/// @return 0 on success, WRONG_ARGUMENT if argument usage is invalid, MEMORY_ERROR if allocation failed
-int lectureCommandsExecution(Lecture* lecture, char* token_2, char* token_3, bool* global_mode, int command)
+/// @brief This function represents a command memory in the lecture mode, see printMemoryReport.
+/// @param session session, the command works on its current lecture
+/// @param arguments unused
+/// @param global_mode unused
+/// @return 0
+int executeMemory(Session* session, Arguments arguments, bool* global_mode)
+{
+  (void)arguments;
+  (void)global_mode;
+  printMemoryReport(&session->registry_, session->registry_.current_->lecture_);
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// Table of all commands, indexed by commandSlot of their names, so that a command is found with one lookup and one
+/// comparison. The slots are chosen so that no two commands share one (-Wextra warns about a slot given twice), a new
+/// command goes into the slot of its name, checkCommandTable says which one at the start of the program. The options
+/// of a command are checked by its ArgumentsCheck after the amount of the arguments.
+const CommandEntry COMMAND_TABLE[COMMAND_TABLE_SIZE] =
+{
+  [1] = {"remove", LECTURE_MODE, 1, ANY_ARGUMENTS, checkRemoveOptions, executeRemove},
+  [2] = {"calc", LECTURE_MODE, 0, 1, checkCalcOptions, executeCalc},
+  [3] = {"export", LECTURE_MODE, 0, 1, checkExportOptions, executeExport},
+  [7] = {"print", LECTURE_MODE, 0, 4, checkPrintOptions, executePrint},
+  [8] = {"give", LECTURE_MODE, 2, 2, NULL, executeGive},
+  [11] = {"close", LECTURE_MODE, 0, 0, NULL, executeClose},
+  [12] = {"load", GLOBAL_MODE, 1, 3, checkLoadOptions, executeLoad},
+  [15] = {"use", GLOBAL_MODE | LECTURE_MODE, 1, 1, NULL, executeUse},
+  [16] = {"memory", LECTURE_MODE, 0, 0, NULL, executeMemory},
+  [18] = {"create", GLOBAL_MODE, 1, 1, NULL, executeCreate},
+  [20] = {"enrol", LECTURE_MODE, 1, 2, checkEnrolOptions, executeEnrol},
+  [21] = {"exit", GLOBAL_MODE | LECTURE_MODE, 0, 0, NULL, NULL}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function hashes the name of a command to its slot in COMMAND_TABLE.
+/// @param name name of the command
+/// @param length length of the name, at least 1
+/// @return slot in the table
+int commandSlot(char* name, int length)
+{
+  return (name[0] + name[length - 1] + 7 * length) & (COMMAND_TABLE_SIZE - 1);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function checks that every command of COMMAND_TABLE is in the slot of its name, a command in another
+/// slot could never be found.
+/// @return true if the table is valid, false otherwise
+bool checkCommandTable(void)
 {
-  if(command == ENROL)
+  bool valid = true;
+  for(int slot = 0; slot < COMMAND_TABLE_SIZE; slot++)
   {
-    int result = enrol(lecture, token_2);
-    if(result == MEMORY_ERROR)
-    {
-      return MEMORY_ERROR;
-    }
-    if(result != 0)//any not memory problem
+    char* name = COMMAND_TABLE[slot].name_;
+    if(name != NULL && commandSlot(name, strlen(name)) != slot)
     {
-      return WRONG_ARGUMENT;
+      printf("Error: Command %s is in slot %d of the command table instead of slot %d!\n", name, slot,
+             commandSlot(name, strlen(name)));
+      valid = false;
     }
   }
-  if(command == REMOVE)
+  return valid;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function identifies the command that the user has typed in.
+/// @param command first token of the line
+/// @return entry of the command in COMMAND_TABLE, NULL if the command typed is unknown
+const CommandEntry* findCommand(Token command)
+{
+  if(command.start_ == NULL)
   {
-    int result = removeStudent(lecture, token_2);
-    if(result == MEMORY_ERROR)
-    {
-      return MEMORY_ERROR;
-    }
-    if(result == STUDENT_NOT_FOUND)
-    {
-      return WRONG_ARGUMENT;
-    }
+    return NULL;
   }
-  if(command == GIVE)
+  const CommandEntry* entry = COMMAND_TABLE + commandSlot(command.start_, command.length_);
+  if(entry->name_ == NULL || strncmp(entry->name_, command.start_, command.length_) != 0 ||
+     entry->name_[command.length_] != '\0')
   {
-    if(give(lecture, token_2, token_3) == WRONG_ARGUMENT)
-    {
-      return WRONG_ARGUMENT;
-    }
+    return NULL;
   }
-  if(command == CALC)
+  return entry;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function tokenises input of the user and executes the command in both modes: the command is found in
+/// COMMAND_TABLE, then the table says whether it can be used in the current mode, how many arguments it takes and how
+/// its options are checked, and the handler of the entry executes it. The arguments stay in the input, nothing is
+/// allocated for them.
+/// @param session session
+/// @param input input of the user
+/// @param global_mode logical variable, represents a global or lecture mode
+/// @return value returned by the handler, QUIT if user typed "exit", WRONG_ARGUMENT if the command is unknown or used
+/// wrongly
+int executeCommand(Session* session, char* input, bool* global_mode)
+{
+  const CommandEntry* entry = findCommand(nextToken(&input));
+  if(entry == NULL)
   {
-    calc(lecture);
+    printf("Error: Unknown command!\n");
+    return WRONG_ARGUMENT;
   }
-  if(command == PRINT)
+  if((entry->modes_ & (*global_mode ? GLOBAL_MODE : LECTURE_MODE)) == 0)
   {
-    print(lecture);
+    printf("Error: This command cannot be used in the current mode!\n");
+    return WRONG_ARGUMENT;
   }
-  if(command == EXPORT)
+  Arguments arguments = splitArguments(input);
+  if(arguments.amount_ < entry->min_arguments_ ||
+     (entry->max_arguments_ != ANY_ARGUMENTS && arguments.amount_ > entry->max_arguments_) ||
+     (entry->check_ != NULL && !entry->check_(arguments)))
   {
-    int result = export(lecture);
-    if(result == MEMORY_ERROR)
-    {
-      return MEMORY_ERROR;
-    }
-    if(result == FILE_ERROR)
-    {
-      return WRONG_ARGUMENT;
-    }
+    printf("Error: Invalid command usage!\n");
+    return WRONG_ARGUMENT;
   }
-  if(command == CLOSE)
+  if(entry->handler_ == NULL)//exit
   {
-    close(lecture, global_mode);
+    return QUIT;
   }
-  return 0;
+  return entry->handler_(session, arguments, global_mode);
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-/// @brief This function represents a lecture mode. It asks user for the input, checks whether the command and its
-/// arguments are correct, executes the command and frees the input.
-/// @param lecture lecture
-/// @param global_mode logical variable, represents a global or lecture mode
-/// @return 0 on success, WRONG_ARGUMENT if argument usage is invalid, MEMORY_ERROR if allocation failed
-int lectureMode(Lecture* lecture, bool* global_mode)
-{
-  char* token_1;
-  char* token_2;
-  char* token_3;
-  char* token_4;
-  printf("[%s] > ", lecture->name_);
-  char* input = readUserInput();
-  if(input == NULL)
+/// @brief This function represents global mode. User is asked to type create/load with arguments. Then lecture is
+/// created or loaded respectively and added to the registry of open lectures, or an open lecture is chosen with use.
+/// @param global_mode bool variable that is used to change modes
+/// @param session session, its reader provides the input and its registry holds the lectures
+/// @return LECTURE_CREATED/FILE_LOADED on success, MEMORY_ERROR if allocation failed, QUIT if user typed "exit" or
+/// the batch input has ended,
+/// other values if something is wrong
+int globalMode(bool* global_mode, Session* session)
+{
+  if(!session->batch_)
   {
-    return MEMORY_ERROR;
+    printf("[] > ");
   }
-  int command = getAndCheckArgumentsLecture(&input, &token_1, &token_2, &token_3, &token_4);
-  if(command == QUIT)
+  char* input = readUserInput(&session->reader_);
+  if(input == NULL)
   {
-    free(input);
-    return QUIT;
+    return endOfInput(session);
   }
-  if(command == WRONG_ARGUMENT)
+  return executeCommand(session, input, global_mode);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function represents a lecture mode. It asks user for the input, checks whether the command and its
+/// arguments are correct, and executes the command on the current lecture.
+/// @param global_mode logical variable, represents a global or lecture mode
+/// @param session session, its reader provides the input and its registry holds the lectures
+/// @return 0 on success, WRONG_ARGUMENT if argument usage is invalid, MEMORY_ERROR if allocation failed, QUIT if user
+/// typed "exit" or the batch input has ended
+int lectureMode(bool* global_mode, Session* session)
+{
+  if(!session->batch_)
   {
-    free(input);
-    return WRONG_ARGUMENT;
+    printf("[%s] > ", session->registry_.current_->lecture_->name_);
   }
-  int result = lectureCommandsExecution(lecture, token_2, token_3, global_mode, command);
-  if(result == MEMORY_ERROR)
+  char* input = readUserInput(&session->reader_);
+  if(input == NULL)
   {
-    free(input);
-    return MEMORY_ERROR;
+    return endOfInput(session);
   }
-  if(result == WRONG_ARGUMENT)
+  return executeCommand(session, input, global_mode);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function counts an executed command and whether it has failed, for the summary of the batch mode.
+/// @param session session
+/// @param result value returned by globalMode or lectureMode
+void countCommand(Session* session, int result)
+{
+  session->commands_++;
+  if(result != 0)
   {
-    free(input);
-    return WRONG_ARGUMENT;
+    session->failed_commands_++;
   }
-  free(input);
-  return 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 /// @brief This function is responsible for the workflow of the main. 
 /// @param global_mode logical variable, represents a global or lecture mode
-/// @param lecture lecture
 /// @param run logical variable, tells whether the program runs or ends
+/// @param session session, lists of commands are printed only if it is not in the batch mode
 /// @return 0 on success, QUIT if user typed "exit", MEMORY_ERROR on memory error
-int flow(bool* global_mode, Lecture** lecture, bool* run)
+int flow(bool* global_mode, bool* run, Session* session)
 {
   if(*global_mode)
   {
-    *lecture = NULL;//because of dangling pointer
-    int result = globalMode(lecture, global_mode);
+    int result = globalMode(global_mode, session);
     if(result == MEMORY_ERROR)
     {
       return MEMORY_ERROR;
@@ -1403,14 +4539,15 @@ int flow(bool* global_mode, Lecture** lecture, bool* run)
       *run = false;
       return QUIT;
     }
-    if(*global_mode == false)
+    countCommand(session, result);
+    if(*global_mode == false && !session->batch_)
     {//we print commands only when the mode changes
       lectureCommandsPrint();
     }
   }
   if(*global_mode == false)
   {
-    int result = lectureMode(*lecture, global_mode);
+    int result = lectureMode(global_mode, session);
     if(result == MEMORY_ERROR)
     {
       return MEMORY_ERROR;
@@ -1420,7 +4557,8 @@ int flow(bool* global_mode, Lecture** lecture, bool* run)
       *run = false;
       return QUIT;
     }
-    if(*global_mode == true)
+    countCommand(session, result);
+    if(*global_mode == true && !session->batch_)
     {//we print commands only when the mode changes
       globalCommandsPrint();
     }
@@ -1428,27 +4566,103 @@ int flow(bool* global_mode, Lecture** lecture, bool* run)
   return 0;
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function prepares the batch mode (--batch <file>): commands are read from the file, or from stdin if
+/// the file is "-", and both input and output get big buffers, because nobody reads the output line by line.
+/// @param session session
+/// @param path path to the file with commands
+/// @return 0 on success, FILE_ERROR if the file could not be opened
+int startBatch(Session* session, char* path)
+{
+  if(strcmp(path, "-") != 0)
+  {
+    session->reader_.input_ = fopen(path, "r");
+    if(session->reader_.input_ == NULL)
+    {
+      printf("Error: Cannot open file: %s!\n", path);
+      return FILE_ERROR;
+    }
+  }
+  session->batch_ = true;
+  setvbuf(session->reader_.input_, NULL, _IOFBF, BATCH_BUFFER_SIZE);
+  setvbuf(stdout, NULL, _IOFBF, BATCH_BUFFER_SIZE);
+  return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+/// @brief This function ends the session. It frees the input buffer, closes the batch file and prints the summary
+/// of the batch mode or a farewell message.
+/// @param session session
+void endSession(Session* session)
+{
+  free(session->reader_.buffer_);
+  if(session->reader_.input_ != stdin)
+  {
+    fclose(session->reader_.input_);
+  }
+  if(session->batch_)
+  {
+    printf("Batch finished: %d commands, %d failed\n", session->commands_, session->failed_commands_);
+    return;
+  }
+  printf("Thank you for using the Intelligent Study Program!\n");
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 /// @brief Stuff happens here! User is greeted, then commands are printed and the program enters loop with a workflow.
-/// In the end a farewell message is printed.
-/// @return 0 - program terminated successfully, 1 - program was not able to allocate new memory
-int main(void)
+/// In the end a farewell message is printed. With --batch <file> the commands are read from the file (or stdin for
+/// "-") without greeting and prompts, and a summary of failed commands is printed instead of the farewell message.
+/// With --budget <megabytes> open lectures are evicted from memory when they need more than the budget.
+/// @param argc amount of arguments
+/// @param argv arguments
+/// @return 0 - program terminated successfully, 1 - program was not able to allocate new memory or the arguments are
+/// invalid
+int main(int argc, char* argv[])
 {
   bool run = true;
   bool global_mode = true;
-  welcomeMessage();
-  globalCommandsPrint();
-  Lecture* lecture = NULL;
+  Session session = {{NULL, 0, stdin}, false, 0, 0, {NULL, 0, 0, NULL, NULL, NULL, 0, 0}};
+  if(!checkCommandTable())
+  {
+    return 1;
+  }
+  for(int argument = 1; argument < argc; argument += 2)
+  {
+    int megabytes = 0;
+    if(argument + 1 < argc && strcmp(argv[argument], "--batch") == 0 && !session.batch_)
+    {
+      if(startBatch(&session, argv[argument + 1]) == FILE_ERROR)
+      {
+        return 1;
+      }
+    }
+    else if(argument + 1 < argc && strcmp(argv[argument], "--budget") == 0 &&
+            parseNumber(argv[argument + 1], &megabytes) == 0 && megabytes > 0)
+    {
+      session.registry_.budget_ = (long)megabytes * 1048576;
+    }
+    else
+    {
+      printf("Usage: %s [--batch <file>] [--budget <megabytes>]\n", argv[0]);
+      return 1;
+    }
+  }
+  if(!session.batch_)
+  {
+    welcomeMessage();
+    globalCommandsPrint();
+  }
   while(run)
   {
-    if(flow(&global_mode, &lecture, &run) == MEMORY_ERROR)
+    if(flow(&global_mode, &run, &session) == MEMORY_ERROR)
     {
       printf("Error: Out of memory!\n");
-      freeLecture(lecture);
+      freeRegistry(&session.registry_);
+      free(session.reader_.buffer_);
       return 1;
     }
   }
-  freeLecture(lecture);
-  printf("Thank you for using the Intelligent Study Program!\n");
+  freeRegistry(&session.registry_);
+  endSession(&session);
   return 0;
 }
@@ -0,0 +1,185 @@
+#!/usr/bin/env bash
+# Benchmarks of a4 on a generated lecture, run from the root of the repository:
+#
+#   bench/bench.sh [-r rows] [-n runs] [-b binary] [-o revision] [benchmark...]
+#
+#   -r rows      rows of the generated lecture, 10000000 by default
+#   -n runs      every measurement is the best of this many runs, 3 by default
+#   -b binary    a4 to measure, by default a4.c is built with -O2 into the work directory
+#   -o revision  git revision with the calc before the grading kernels, compared by the calc benchmark
+#
+# Benchmarks, all of them if none is given:
+#   load        load, load --mmap and load --threads 1, 2, 4 and 8 on the whole lecture
+#   calc        calc with the AVX2, SSE2 and scalar grading kernels and with the calc of the old revision
+#   give        give to random students of lectures of growing size, the name index keeps it flat
+#   reader      reading many short and a few very long command lines
+#   export      export and export --binary of the whole lecture, 10 times each
+#
+# Every measurement runs a4 --batch on a command file and reports the best wall time. Commands that run on a loaded
+# lecture are timed as the difference to loading it alone, from its binary snapshot if the binary can read it.
+# Results depend on the amount of cores, which is printed first: load --threads cannot scale beyond it.
+set -e
+
+ROWS=10000000
+RUNS=3
+A4=
+OLD_REVISION=$(git log -1 --format=%h --grep='^\[user-013\] Store points and grades in columns' 2>/dev/null || true)
+OLD_REVISION=${OLD_REVISION:+$OLD_REVISION^}
+while getopts r:n:b:o: option; do
+  case $option in
+    r) ROWS=$OPTARG ;;
+    n) RUNS=$OPTARG ;;
+    b) A4=$(realpath "$OPTARG") ;;
+    o) OLD_REVISION=$OPTARG ;;
+    *) sed -n '2,21s/^# \{0,1\}//p' "$0"; exit 1 ;;
+  esac
+done
+shift $((OPTIND - 1))
+BENCHMARKS=${*:-load calc give reader export}
+for benchmark in $BENCHMARKS; do
+  case $benchmark in
+    load | calc | give | reader | export) ;;
+    *) echo "Unknown benchmark $benchmark!" >&2; exit 1 ;;
+  esac
+done
+
+BENCH_DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+build() {
+  ${CC:-gcc} -std=c11 -O2 -pthread "${@:2}" -o "$WORK/$1" "$BENCH_DIR/../a4.c"
+}
+BUILT=
+if [ -z "$A4" ]; then
+  build a4
+  A4=$WORK/a4
+  BUILT=yes
+fi
+mkdir "$WORK/reports"
+python3 "$BENCH_DIR/gen_lecture.py" "$ROWS" > "$WORK/lecture.csv"
+echo "cores: $(nproc), rows: $ROWS, best of $RUNS runs"
+
+# best wall time in seconds of the binary (a4 by default) running the commands on standard input
+measure() {
+  local binary=${1:-$A4}
+  cat > "$WORK/commands.txt"
+  local best=
+  for _ in $(seq "$RUNS"); do
+    local start end
+    rm -rf "$WORK/reports" && mkdir "$WORK/reports"
+    start=$(date +%s.%N)
+    (cd "$WORK" && "$binary" --batch commands.txt > output.txt)
+    end=$(date +%s.%N)
+    best=$(echo "$start $end ${best:-0}" | awk '{t = $2 - $1; print ($3 == 0 || t < $3) ? t : $3}')
+  done
+  if grep -q '^Error' "$WORK/output.txt"; then
+    grep -m 1 '^Error' "$WORK/output.txt" >&2
+    exit 1
+  fi
+  echo "$best"
+}
+
+# writes the binary snapshot <name>.bin of the lecture file <name>.csv next to it, it loads faster and steadier
+snapshot() {
+  (cd "$WORK" && printf 'load --mmap %s.csv\nexport --binary\nexit\n' "$1" | "$A4" --batch - > /dev/null)
+  mv "$WORK/reports/$1.bin" "$WORK/$1.bin"
+}
+
+# best wall time of the commands after loading the file minus the time of the load alone
+measure_after_load() {
+  local binary=$1 load="load $2"
+  if [ "${2%.csv}" != "$2" ]; then
+    load="load --mmap $2"
+  fi
+  cat > "$WORK/after_load.txt"
+  local loaded total
+  loaded=$(printf '%s\nexit\n' "$load" | measure "$binary")
+  total=$( (echo "$load"; cat "$WORK/after_load.txt"; echo exit) | measure "$binary")
+  awk -v total="$total" -v loaded="$loaded" 'BEGIN {print (total > loaded) ? total - loaded : 0.000001}'
+}
+
+# prints a row of results: name, seconds and how many of the unit are done per second
+report() {
+  awk -v name="$1" -v seconds="$2" -v amount="$3" -v unit="$4" \
+    'BEGIN {printf "  %-36s %9.3f s %14.0f %s/s\n", name, seconds, amount / seconds, unit}'
+}
+
+bench_load() {
+  echo "load"
+  local seconds
+  seconds=$(printf 'load lecture.csv\nexit\n' | measure)
+  report "load" "$seconds" "$ROWS" rows
+  seconds=$(printf 'load --mmap lecture.csv\nexit\n' | measure)
+  report "load --mmap" "$seconds" "$ROWS" rows
+  for threads in 1 2 4 8; do
+    seconds=$(printf 'load --threads %d lecture.csv\nexit\n' "$threads" | measure)
+    report "load --threads $threads" "$seconds" "$ROWS" rows
+  done
+}
+
+bench_calc() {
+  echo "calc"
+  snapshot lecture
+  local kernels=("$A4") names=("calc") files=(lecture.bin) amounts=(2000)
+  if [ -n "$BUILT" ]; then
+    build a4_sse2 -DNO_AVX2_GRADING
+    build a4_scalar -DSCALAR_GRADING
+    kernels=("$A4" "$WORK/a4_sse2" "$WORK/a4_scalar")
+    names=("calc, AVX2 if supported" "calc, SSE2" "calc, scalar")
+    files=(lecture.bin lecture.bin lecture.bin)
+    amounts=(2000 2000 200)
+  fi
+  if [ -n "$OLD_REVISION" ] && git show "$OLD_REVISION:a4.c" > "$WORK/old.c" 2>/dev/null; then
+    ${CC:-gcc} -std=c11 -O2 -pthread -o "$WORK/a4_old" "$WORK/old.c"
+    kernels+=("$WORK/a4_old")
+    names+=("calc of $OLD_REVISION")
+    files+=(lecture.csv)
+    amounts+=(200)
+  fi
+  for index in "${!kernels[@]}"; do
+    local seconds
+    seconds=$(yes calc | head -n "${amounts[$index]}" |
+      measure_after_load "${kernels[$index]}" "${files[$index]}")
+    report "${names[$index]}, ${amounts[$index]} times" "$seconds" $((ROWS * amounts[index])) students
+  done
+}
+
+bench_give() {
+  local amount_gives=1000000
+  echo "give, $amount_gives times"
+  for size in 1000 10000 100000 1000000 10000000; do
+    if [ "$size" -gt "$ROWS" ]; then
+      break
+    fi
+    head -n "$size" "$WORK/lecture.csv" > "$WORK/part.csv"
+    snapshot part
+    local seconds
+    seconds=$(awk -v amount=$amount_gives -F , '{names[NR] = $1} END {srand(1); for(i = 0; i < amount; i++)
+      print "give 0 " names[int(rand() * NR) + 1]}' "$WORK/part.csv" | measure_after_load "$A4" part.bin)
+    report "give, $size students" "$seconds" $amount_gives gives
+  done
+}
+
+bench_reader() {
+  echo "reader"
+  local amount_short=1000000 amount_long=1024 seconds padding
+  seconds=$( (echo "create reader"; yes calc | head -n $amount_short; echo exit) | measure)
+  report "$amount_short short lines" "$seconds" $amount_short lines
+  padding=$(printf '%65536s' '')
+  seconds=$( (echo "create reader"; for _ in $(seq $amount_long); do echo "calc$padding"; done; echo exit) | measure)
+  report "$amount_long lines of 64 KiB" "$seconds" $((amount_long / 16)) MiB
+}
+
+bench_export() {
+  local amount_exports=10 seconds
+  echo "export, $amount_exports times"
+  snapshot lecture
+  seconds=$(yes export | head -n $amount_exports | measure_after_load "$A4" lecture.bin)
+  report "export" "$seconds" $((ROWS * amount_exports)) rows
+  seconds=$(yes 'export --binary' | head -n $amount_exports | measure_after_load "$A4" lecture.bin)
+  report "export --binary" "$seconds" $((ROWS * amount_exports)) rows
+}
+
+for benchmark in $BENCHMARKS; do
+  "bench_$benchmark"
+done
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Writes a lecture file with unique student names for the benchmarks in bench.sh.
+
+Usage: gen_lecture.py <rows> [seed] > lecture.csv
+
+Every row is "name,points,grade" like the rows of an export. Names are five letters, spread over the whole alphabet so
+that neither the file nor the name index sees them in sorted order. Grades are the ones calc would give.
+"""
+import random
+import sys
+
+LETTERS = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+NAME_SPACE = len(LETTERS) ** 5
+SPREAD = 2654435761  # odd and not a multiple of 13, so i -> i * SPREAD is a permutation of NAME_SPACE
+
+
+def name(index):
+    number = index * SPREAD % NAME_SPACE
+    characters = []
+    for _ in range(5):
+        number, digit = divmod(number, len(LETTERS))
+        characters.append(LETTERS[digit])
+    return "".join(characters)
+
+
+def grade(points):
+    for grade_value, threshold in ((1, 87), (2, 75), (3, 62), (4, 51)):
+        if points >= threshold:
+            return grade_value
+    return 5
+
+
+def main():
+    if len(sys.argv) not in (2, 3) or not sys.argv[1].isdigit() or int(sys.argv[1]) > NAME_SPACE:
+        sys.exit("Usage: gen_lecture.py <rows> [seed]")
+    rows = int(sys.argv[1])
+    random.seed(int(sys.argv[2]) if len(sys.argv) == 3 else 1)
+    out = sys.stdout
+    batch = []
+    for index in range(rows):
+        points = random.randint(0, 100)
+        batch.append("%s,%d,%d\n" % (name(index), points, grade(points)))
+        if len(batch) == 65536:
+            out.write("".join(batch))
+            batch = []
+    out.write("".join(batch))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,53 @@
+"""Helpers shared by the tests in this directory, see run_tests.sh.
+
+Every test is started as "python3 test_<name>.py <a4 binary>" in an empty directory of its own.
+"""
+import os
+import shutil
+import subprocess
+import sys
+
+NAME_LENGTHS = [1, 5, 21, 22, 23, 40, 300]  # around the 22 characters a student record holds itself
+
+
+def binary():
+    if len(sys.argv) != 2:
+        sys.exit("Usage: %s <a4 binary>" % os.path.basename(sys.argv[0]))
+    return os.path.realpath(sys.argv[1])
+
+
+def fail(message):
+    print("FAIL: " + message)
+    sys.exit(1)
+
+
+def run(commands, options=()):
+    """Runs the commands with a4 --batch and returns what it printed, sanitizer reports fail the test."""
+    result = subprocess.run([binary()] + list(options) + ["--batch", "-"], input="\n".join(commands) + "\n",
+                            capture_output=True, text=True, env=dict(os.environ, ASAN_OPTIONS="symbolize=0"))
+    if "ERROR: AddressSanitizer" in result.stderr or "runtime error" in result.stderr:
+        fail("sanitizer report for the commands\n" + "\n".join(commands) + "\n" + result.stderr[-2000:])
+    return result.stdout
+
+
+def reset_reports():
+    shutil.rmtree("reports", ignore_errors=True)
+    os.mkdir("reports")
+
+
+def random_name(rng, letters="abAB"):
+    return "".join(rng.choice(letters) for _ in range(rng.choice(NAME_LENGTHS)))
+
+
+def write_lecture(path, rng, amount_students):
+    """Writes a lecture file with unique names of all lengths and returns the names."""
+    names = []
+    seen = set()
+    while len(names) < amount_students:
+        name = random_name(rng)
+        if name not in seen:
+            seen.add(name)
+            names.append(name)
+    with open(path, "w") as lecture:
+        lecture.writelines("%s,%d,%d\n" % (name, rng.randint(0, 100), rng.randint(0, 5)) for name in names)
+    return names
@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+# Tests of a4, run from the root of the repository:
+#
+#   tests/run_tests.sh [binary] [test...]
+#
+# By default a4.c is built with AddressSanitizer and UndefinedBehaviorSanitizer, and all test_*.py are run. Every
+# test runs in an empty temporary directory, which is kept when the test fails.
+set -e
+
+TESTS_DIR=$(cd "$(dirname "$0")" && pwd)
+BUILD=$(mktemp -d)
+trap 'rm -rf "$BUILD"' EXIT
+if [ -n "$1" ] && [ -x "$1" ]; then
+  A4=$(realpath "$1")
+  shift
+else
+  A4=$BUILD/a4
+  ${CC:-gcc} -std=c11 -Wall -Wextra -pedantic -g -fsanitize=address,undefined -pthread -o "$A4" "$TESTS_DIR/../a4.c"
+fi
+TESTS=${*:-$(cd "$TESTS_DIR" && ls test_*.py | sed 's/^test_\(.*\)\.py$/\1/')}
+
+failed=0
+for test in $TESTS; do
+  work=$(mktemp -d)
+  if (cd "$work" && PYTHONPATH=$TESTS_DIR PYTHONDONTWRITEBYTECODE=1 python3 "$TESTS_DIR/test_$test.py" "$A4"); then
+    echo "PASS $test"
+    rm -rf "$work"
+  else
+    echo "FAIL $test, see $work"
+    failed=$((failed + 1))
+  fi
+done
+if [ $failed -ne 0 ]; then
+  echo "$failed failed"
+  exit 1
+fi
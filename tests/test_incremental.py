@@ -0,0 +1,47 @@
+"""export --incremental: at random points of a session the patched snapshot must be byte-identical to the snapshot a
+full export --binary writes for the same state."""
+import os
+import random
+
+from common import fail, reset_reports, run, write_lecture
+
+
+def snapshot(commands):
+    reset_reports()
+    output = run(commands + ["exit"])
+    with open("reports/ln.bin", "rb") as file:
+        return output, file.read()
+
+
+def main():
+    rng = random.Random(1)
+    names = write_lecture("ln.csv", rng, 150)
+    commands = ["load ln.csv"]
+    checks = 0
+    for _ in range(120):
+        choice = rng.random()
+        if choice < 0.5:
+            commands.append("give %d %s" % (rng.randint(-3, 5), rng.choice(names)))
+        elif choice < 0.55:
+            commands.append("enrol " + "".join(rng.choice("pq") for _ in range(6)))
+        elif choice < 0.58:
+            commands.append("remove " + rng.choice(names))
+        elif choice < 0.63:
+            commands.append(rng.choice(["calc", "calc --lazy"]))
+        elif choice < 0.66:
+            commands.append("export --binary")
+        elif choice < 0.68:
+            commands += rng.choice([["close", "use ln"], ["memory"]])
+        else:
+            commands.append("export --incremental")
+            if rng.random() < 0.5:
+                checks += 1
+                incremental_output, incremental = snapshot(commands)
+                full_output, full = snapshot(commands[:-1] + ["export --binary"])
+                if incremental != full or incremental_output != full_output:
+                    fail("export --incremental differs from export --binary after\n" + "\n".join(commands))
+    if checks == 0 or not os.path.exists("reports/ln.bin"):
+        fail("no snapshot was compared")
+
+
+main()
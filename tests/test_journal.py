@@ -0,0 +1,78 @@
+"""Journal of changes: after a random session on reports/x.csv, loading the report replays the journal to the same
+state. A journal torn at a random byte, like after a crash, recovers the state after some prefix of the commands."""
+import random
+
+from common import fail, reset_reports, run, write_lecture
+
+AMOUNT_COMMANDS = 40
+
+
+def session(rng, names, step):
+    commands = ["load reports/x.csv"]
+    names = list(names)
+    for index in range(AMOUNT_COMMANDS):
+        choice = rng.random()
+        if choice < 0.2:
+            name = "".join(rng.choice("pqrs") for _ in range(rng.choice([2, 4, 25])))
+            commands.append("enrol " + name)
+            names.append(name)
+        elif choice < 0.3:
+            roster = "roster%d_%d.txt" % (step, index)
+            with open(roster, "w") as file:
+                file.writelines("".join(rng.choice("tuvw") for _ in range(rng.choice([3, 5, 30]))) + "\n"
+                                for _ in range(3))
+            commands.append("enrol --from " + roster)
+        elif choice < 0.45:
+            commands.append(rng.choice(["remove ", "remove --swap "]) + " ".join(rng.sample(names, rng.randint(1, 3))))
+        elif choice < 0.75:
+            commands.append("give %d %s" % (rng.randint(-5, 9), rng.choice(names)))
+        elif choice < 0.8:
+            changes = "changes%d_%d.txt" % (step, index)
+            with open(changes, "w") as file:
+                file.writelines("%s,%+d\n" % (rng.choice(names), rng.randint(-3, 3)) for _ in range(3))
+            commands.append("give --from " + changes)
+        elif choice < 0.85:
+            commands.append("export")
+        elif choice < 0.9:
+            commands.append("calc")
+        elif choice < 0.95:
+            commands += ["close", "use x"]
+        else:
+            commands.append("print --range 0:2")
+    return commands
+
+
+def state(commands):
+    """Returns the lecture as printed after calc at the end of the commands."""
+    output = run(commands + ["calc", "print", "exit"])
+    return output[output.rfind("Lecture: x"):].split("Batch")[0]
+
+
+def main():
+    for step in range(4):
+        rng = random.Random(step)
+        reset_reports()
+        names = write_lecture("reports/x.csv", rng, 60)
+        with open("reports/x.csv") as report:
+            base = report.read()
+        commands = session(rng, names, step)
+        full = state(commands)
+        if state(["load reports/x.csv"]) != full:
+            fail("step %d: the replayed journal differs from the session" % step)
+        with open("reports/x.log", "rb") as journal:
+            records = journal.read()
+        header = len(records.split(b"\n")[0]) + 1
+        with open("reports/x.log", "wb") as journal:
+            journal.write(records[:rng.randint(header, len(records))])
+        torn = state(["load reports/x.csv"])
+        for length in range(len(commands), 0, -1):
+            reset_reports()
+            with open("reports/x.csv", "w") as report:
+                report.write(base)
+            if state(commands[:length]) == torn:
+                break
+        else:
+            fail("step %d: the torn journal recovered no prefix of the session" % step)
+
+
+main()
@@ -0,0 +1,68 @@
+"""Several open lectures (use, close, --budget): random sessions over seven lectures, one of them large enough to be
+evicted, print the same with and without --budget 1. No spill file is left behind and no warning is printed."""
+import os
+import random
+
+from common import fail, reset_reports, run, write_lecture
+
+AMOUNT_LECTURES = 7
+
+
+def session(rng, names, amount_commands):
+    commands = []
+    opened = set()
+    lecture_mode = False
+    for _ in range(amount_commands):
+        choice = rng.random()
+        if not lecture_mode or choice < 0.12:
+            lecture = "l%d" % rng.randrange(AMOUNT_LECTURES)
+            if lecture in opened and (lecture_mode or rng.random() < 0.8):
+                commands.append("use " + lecture)
+            else:
+                commands.append(rng.choice(["load ", "load --mmap "]) + "lectures/%s.csv" % lecture)
+                opened.add(lecture)
+            lecture_mode = True
+        elif choice < 0.2:
+            commands.append("close")
+            lecture_mode = False
+        elif choice < 0.4:
+            commands.append("give %d %s" % (rng.randint(1, 5), rng.choice(names)))
+        elif choice < 0.5:
+            commands.append("enrol " + "".join(rng.choice("xyzXYZ") for _ in range(rng.choice([3, 30]))))
+        elif choice < 0.55:
+            commands.append("remove " + rng.choice(names))
+        elif choice < 0.65:
+            commands.append(rng.choice(["calc", "calc --lazy"]))
+        elif choice < 0.9:
+            commands.append("print --range %d:5" % rng.randint(0, 400))
+        else:
+            commands.append(rng.choice(["print --sort points --limit 5", "print --sort name --limit 4", "export"]))
+    return commands + ["exit"]
+
+
+def main():
+    os.mkdir("lectures")
+    for seed in range(1, 4):
+        rng = random.Random(seed)
+        large = "lectures/l%d.csv" % (AMOUNT_LECTURES - 1)
+        names = write_lecture(large, rng, 200000)[:400]
+        with open(large) as lecture:
+            rows = [next(lecture) for _ in names]
+        for lecture in range(AMOUNT_LECTURES - 1):
+            with open("lectures/l%d.csv" % lecture, "w") as small:
+                small.writelines(rows)
+        commands = session(rng, names, 400)
+        outputs = []
+        for options in [[], ["--budget", "1"]]:
+            reset_reports()
+            outputs.append(run(commands, options))
+            spilled = [name for name in os.listdir("reports") if name.startswith(".")]
+            if spilled:
+                fail("seed %d %s left spill files %s" % (seed, " ".join(options), spilled))
+            if "Warning: Lecture" in outputs[-1]:
+                fail("seed %d %s printed a warning" % (seed, " ".join(options)))
+        if outputs[0] != outputs[1]:
+            fail("seed %d prints differently with --budget 1" % seed)
+
+
+main()
@@ -0,0 +1,28 @@
+"""Tokenizer edge cases: blank lines, tabs, missing and extra arguments and short load paths print exactly
+tokenizer_edge.expected. The files the script loads are written first."""
+import os
+
+from common import fail, run
+
+TESTS_DIR = os.path.dirname(os.path.realpath(__file__))
+LECTURE = "a,10,0\nb,20,0\nc,30,0\nd,1,0\ne,2,0\n"
+
+
+def main():
+    os.mkdir("reports")
+    os.mkdir("sub")
+    for path in ["ed.csv", "ab", "abcd", "sub/x.c"]:
+        with open(path, "w") as file:
+            file.write(LECTURE)
+    with open(os.path.join(TESTS_DIR, "tokenizer_edge.txt")) as file:
+        commands = file.read().split("\n")[:-1]
+    with open(os.path.join(TESTS_DIR, "tokenizer_edge.expected")) as file:
+        expected = file.read()
+    output = run(commands)
+    if output != expected:
+        with open("tokenizer_edge.out", "w") as file:
+            file.write(output)
+        fail("output differs from tokenizer_edge.expected, see tokenizer_edge.out")
+
+
+main()